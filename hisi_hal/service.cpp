@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2024 The LineageOS Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#define LOG_TAG "vendor.lineage.hal-service.hisi"
+
+#include <android-base/logging.h>
+#include <android-base/properties.h>
+#include <android/binder_manager.h>
+#include <android/binder_process.h>
+#include <sys/system_properties.h>
+
+#include <algorithm>
+#include <thread>
+
+#include "ColorPipeline.h"
+#include "DisplayColorCalibration.h"
+#include "DisplayModes.h"
+#include "GloveMode.h"
+#include "HighTouchPollingRate.h"
+#include "PictureAdjustment.h"
+#include "TouchscreenGesture.h"
+
+using ::aidl::vendor::lineage::livedisplay::ColorPipeline;
+using ::aidl::vendor::lineage::livedisplay::DisplayColorCalibration;
+using ::aidl::vendor::lineage::livedisplay::DisplayModes;
+using ::aidl::vendor::lineage::livedisplay::PictureAdjustment;
+using ::aidl::vendor::lineage::touch::GloveMode;
+using ::aidl::vendor::lineage::touch::HighTouchPollingRate;
+using ::aidl::vendor::lineage::touch::TouchscreenGesture;
+
+// Every interface serializes its own calls, so one binder thread per
+// interface keeps i.e. a slow glove write from blocking gesture or
+// display requests.
+constexpr const char* kPropThreadpoolSize = "ro.vendor.hisi.hal_threads";
+constexpr size_t kDefaultThreadpoolSize = 6;
+constexpr size_t kMaxThreadpoolSize = 8;
+
+// A local client (i.e. a game booster) sets this to the touch profile of
+// the app in the foreground, or clears it to go back to the user's setting.
+constexpr const char* kPropTouchProfile = "vendor.touch.profile";
+
+// Features the device lacks are not registered at all, so clients see
+// them as unavailable instead of getting errors from every call. Each
+// feature has its own VINTF fragment, which the device must only ship
+// along with the node, or waitForDeclaredService() never returns.
+template <typename T>
+static bool AddService(const std::shared_ptr<T>& service) {
+    const std::string instance = std::string(T::descriptor) + "/default";
+
+    if (!service->isSupported()) {
+        LOG(WARNING) << "Not registering " << instance
+                     << ", not supported on this device. Drop its VINTF fragment.";
+        return true;
+    }
+
+    if (AServiceManager_addService(service->asBinder().get(), instance.c_str()) != STATUS_OK) {
+        LOG(ERROR) << "Cannot register " << instance;
+        return false;
+    }
+
+    return true;
+}
+
+static void WatchTouchProfile(const std::shared_ptr<HighTouchPollingRate>& highTouchPollingRate) {
+    const prop_info* pi = nullptr;
+    uint32_t serial = 0;
+
+    // Until the property is first set, any property change wakes us up.
+    while ((pi = __system_property_find(kPropTouchProfile)) == nullptr) {
+        __system_property_wait(nullptr, serial, &serial, nullptr);
+    }
+
+    serial = 0;
+    while (true) {
+        __system_property_wait(pi, serial, &serial, nullptr);
+        highTouchPollingRate->setAppProfile(android::base::GetProperty(kPropTouchProfile, ""));
+    }
+}
+
+int main() {
+    size_t threads = android::base::GetUintProperty(kPropThreadpoolSize, kDefaultThreadpoolSize,
+                                                    kMaxThreadpoolSize);
+    // The main thread joins the pool as well.
+    ABinderProcess_setThreadPoolMaxThreadCount(std::max<size_t>(threads, 1) - 1);
+    ABinderProcess_startThreadPool();
+
+    // All display features end up in the same panel matrix.
+    auto pipeline = std::make_shared<ColorPipeline>();
+
+    auto gloveMode = ndk::SharedRefBase::make<GloveMode>();
+    auto touchscreenGesture = ndk::SharedRefBase::make<TouchscreenGesture>();
+    auto highTouchPollingRate = ndk::SharedRefBase::make<HighTouchPollingRate>();
+    auto dcc = ndk::SharedRefBase::make<DisplayColorCalibration>(pipeline);
+    auto dm = ndk::SharedRefBase::make<DisplayModes>(pipeline);
+    auto pa = ndk::SharedRefBase::make<PictureAdjustment>(pipeline);
+
+    if (!AddService(gloveMode) || !AddService(touchscreenGesture) ||
+        !AddService(highTouchPollingRate) || !AddService(dcc) || !AddService(dm) ||
+        !AddService(pa)) {
+        return 1;
+    }
+
+    // App profiles only make sense on panels that can switch their report rate.
+    if (highTouchPollingRate->isSupported()) {
+        std::thread(WatchTouchProfile, highTouchPollingRate).detach();
+    }
+
+    LOG(INFO) << "Touch and LiveDisplay HAL service is ready.";
+
+    ABinderProcess_joinThreadPool();
+
+    LOG(ERROR) << "Touch and LiveDisplay HAL service failed to join thread pool.";
+    return 1;
+}
@@ -0,0 +1,43 @@
+/*
+ * Copyright (C) 2024 The LineageOS Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <gtest/gtest.h>
+
+#include <hisi_fake_root.h>
+
+#include "GloveMode.h"
+
+using ::aidl::vendor::lineage::touch::GloveMode;
+
+static constexpr const char* kGloveNode = "/sys/touchscreen/touch_glove";
+
+TEST(GloveModeTest, ReadsAndWritesNode) {
+    FakeRoot root;
+    ASSERT_TRUE(root.WriteFile(kGloveNode, "1\n"));
+
+    auto glove = ndk::SharedRefBase::make<GloveMode>();
+    ASSERT_TRUE(glove->isSupported());
+
+    bool enabled = false;
+    ASSERT_TRUE(glove->getEnabled(&enabled).isOk());
+    EXPECT_TRUE(enabled);
+
+    ASSERT_TRUE(glove->setEnabled(false).isOk());
+    EXPECT_EQ("0", root.ReadFile(kGloveNode));
+    ASSERT_TRUE(glove->getEnabled(&enabled).isOk());
+    EXPECT_FALSE(enabled);
+}
+
+TEST(GloveModeTest, UnsupportedWithoutNode) {
+    FakeRoot root;
+
+    auto glove = ndk::SharedRefBase::make<GloveMode>();
+    EXPECT_FALSE(glove->isSupported());
+
+    bool enabled;
+    EXPECT_EQ(EX_ILLEGAL_STATE, glove->getEnabled(&enabled).getExceptionCode());
+    EXPECT_EQ(EX_ILLEGAL_STATE, glove->setEnabled(true).getExceptionCode());
+}
@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2024 The LineageOS Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <gtest/gtest.h>
+
+#include <hisi_fake_root.h>
+
+#include "HighTouchPollingRate.h"
+
+using ::aidl::vendor::lineage::touch::HighTouchPollingRate;
+
+static constexpr const char* kReportRateNode = "/sys/touchscreen/report_rate";
+static constexpr const char* kScanModeNode = "/sys/touchscreen/scan_mode";
+
+TEST(HighTouchPollingRateTest, UnsupportedWithoutNode) {
+    FakeRoot root;
+
+    EXPECT_FALSE(ndk::SharedRefBase::make<HighTouchPollingRate>()->isSupported());
+}
+
+TEST(HighTouchPollingRateTest, StartsFromNodeState) {
+    FakeRoot root;
+    bool enabled;
+
+    ASSERT_TRUE(root.WriteFile(kReportRateNode, "1\n"));
+    auto rate = ndk::SharedRefBase::make<HighTouchPollingRate>();
+    ASSERT_TRUE(rate->isSupported());
+    ASSERT_TRUE(rate->getEnabled(&enabled).isOk());
+    EXPECT_TRUE(enabled);
+
+    ASSERT_TRUE(root.WriteFile(kReportRateNode, "0\n"));
+    rate = ndk::SharedRefBase::make<HighTouchPollingRate>();
+    ASSERT_TRUE(rate->getEnabled(&enabled).isOk());
+    EXPECT_FALSE(enabled);
+}
+
+TEST(HighTouchPollingRateTest, AppliesDeviceProfiles) {
+    FakeRoot root;
+    ASSERT_TRUE(root.WriteFile("/vendor/etc/touch_profiles.conf",
+                               "# name report_rate scan_mode\n"
+                               "default 60 1\n"
+                               "high 120 2\n"));
+    ASSERT_TRUE(root.WriteFile(kReportRateNode, "120\n"));
+    ASSERT_TRUE(root.WriteFile(kScanModeNode, "2\n"));
+
+    auto rate = ndk::SharedRefBase::make<HighTouchPollingRate>();
+    bool enabled;
+    ASSERT_TRUE(rate->getEnabled(&enabled).isOk());
+    EXPECT_TRUE(enabled);
+
+    ASSERT_TRUE(rate->setEnabled(false).isOk());
+    EXPECT_EQ("60", root.ReadFile(kReportRateNode));
+    EXPECT_EQ("1", root.ReadFile(kScanModeNode));
+    ASSERT_TRUE(rate->getEnabled(&enabled).isOk());
+    EXPECT_FALSE(enabled);
+}
+
+TEST(HighTouchPollingRateTest, AppProfileOverridesUserSetting) {
+    FakeRoot root;
+    ASSERT_TRUE(root.WriteFile("/vendor/etc/touch_profiles.conf",
+                               "default 60\n"
+                               "high 120\n"
+                               "game 240 3\n"));
+    ASSERT_TRUE(root.WriteFile(kReportRateNode, "60\n"));
+    ASSERT_TRUE(root.WriteFile(kScanModeNode, "1\n"));
+
+    auto rate = ndk::SharedRefBase::make<HighTouchPollingRate>();
+    rate->setAppProfile("game");
+    EXPECT_EQ("240", root.ReadFile(kReportRateNode));
+    EXPECT_EQ("3", root.ReadFile(kScanModeNode));
+
+    // The user's setting only takes effect once the app profile is cleared.
+    ASSERT_TRUE(rate->setEnabled(true).isOk());
+    EXPECT_EQ("240", root.ReadFile(kReportRateNode));
+
+    rate->setAppProfile("");
+    EXPECT_EQ("120", root.ReadFile(kReportRateNode));
+
+    rate->setAppProfile("unknown");
+    EXPECT_EQ("120", root.ReadFile(kReportRateNode));
+}
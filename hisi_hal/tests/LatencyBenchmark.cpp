@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2024 The LineageOS Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <hisi_fake_root.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "ColorPipeline.h"
+#include "DisplayColorCalibration.h"
+#include "GloveMode.h"
+#include "TouchscreenGesture.h"
+
+using ::aidl::vendor::lineage::livedisplay::ColorPipeline;
+using ::aidl::vendor::lineage::livedisplay::DisplayColorCalibration;
+using ::aidl::vendor::lineage::touch::Gesture;
+using ::aidl::vendor::lineage::touch::GloveMode;
+using ::aidl::vendor::lineage::touch::TouchscreenGesture;
+
+// Stands in for the single binder thread the services used to run on.
+static std::mutex sProcessLock;
+
+// Clients don't call back to back, which would also let the timed
+// caller keep retaking the process lock ahead of everyone else.
+static constexpr std::chrono::microseconds kCallInterval{50};
+
+template <typename F>
+static void Call(bool serialized, F&& call) {
+    if (!serialized) {
+        call();
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(sProcessLock);
+    call();
+}
+
+// Times glove mode writes while other clients keep the calibration and
+// gesture interfaces busy writing their own nodes. range(0) is the
+// number of busy clients, range(1) is 1 to serialize every call like
+// the old single threaded service did.
+static void BM_GloveModeLatency(benchmark::State& state) {
+    const int clients = state.range(0);
+    const bool serialized = state.range(1) != 0;
+
+    FakeRoot root;
+    root.WriteFile("/sys/touchscreen/touch_glove", "0\n");
+    root.WriteFile("/sys/touchscreen/easy_wakeup_gesture", "0x0000\n");
+    root.WriteFile("/sys/devices/virtual/graphics/fb0/lcd_color_temperature",
+                   "32768,0,0,0,32768,0,0,0,32768\n");
+
+    auto pipeline = std::make_shared<ColorPipeline>();
+    auto glove = ndk::SharedRefBase::make<GloveMode>();
+    auto dcc = ndk::SharedRefBase::make<DisplayColorCalibration>(pipeline);
+    auto tg = ndk::SharedRefBase::make<TouchscreenGesture>();
+
+    std::vector<Gesture> gestures;
+    tg->getSupportedGestures(&gestures);
+
+    std::atomic<bool> stop = false;
+    std::vector<std::thread> busy;
+    for (int i = 0; i < clients; i++) {
+        busy.emplace_back([&, i] {
+            for (int n = 0; !stop; n++) {
+                Call(serialized, [&] {
+                    if (i % 2 == 0) {
+                        dcc->setCalibration({32768, 32768 - n % 2, 32768});
+                    } else {
+                        // Writes the gesture node right away.
+                        tg->setGestureEnabled(gestures[0], n % 2 == 0);
+                        tg->flush();
+                    }
+                });
+            }
+        });
+    }
+
+    std::vector<int64_t> latencies;
+    for (auto _ : state) {
+        std::this_thread::sleep_for(kCallInterval);
+
+        // Every call flips the value, so each one writes the node.
+        auto start = std::chrono::steady_clock::now();
+        Call(serialized, [&] { glove->setEnabled(latencies.size() % 2 == 0); });
+        std::chrono::nanoseconds latency = std::chrono::steady_clock::now() - start;
+
+        latencies.push_back(latency.count());
+        state.SetIterationTime(std::chrono::duration<double>(latency).count());
+    }
+
+    stop = true;
+    for (auto& thread : busy) thread.join();
+
+    std::sort(latencies.begin(), latencies.end());
+    state.counters["p50_ns"] = latencies[latencies.size() / 2];
+    state.counters["p99_ns"] = latencies[latencies.size() * 99 / 100];
+}
+BENCHMARK(BM_GloveModeLatency)
+        ->ArgsProduct({{0, 2, 6}, {0, 1}})
+        ->ArgNames({"clients", "serialized"})
+        ->UseManualTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,164 @@
+/*
+ * Copyright (C) 2024 The LineageOS Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <gtest/gtest.h>
+
+#include <android-base/strings.h>
+#include <hisi_fake_root.h>
+
+#include <chrono>
+#include <thread>
+
+#include "ColorPipeline.h"
+#include "DisplayColorCalibration.h"
+#include "DisplayModes.h"
+#include "PictureAdjustment.h"
+
+using ::aidl::vendor::lineage::livedisplay::ColorMatrix;
+using ::aidl::vendor::lineage::livedisplay::ColorPipeline;
+using ::aidl::vendor::lineage::livedisplay::DisplayColorCalibration;
+using ::aidl::vendor::lineage::livedisplay::DisplayMode;
+using ::aidl::vendor::lineage::livedisplay::DisplayModes;
+using ::aidl::vendor::lineage::livedisplay::FloatRange;
+using ::aidl::vendor::lineage::livedisplay::HSIC;
+using ::aidl::vendor::lineage::livedisplay::PictureAdjustment;
+
+static constexpr const char* kColorNode = "/sys/devices/virtual/graphics/fb0/lcd_color_temperature";
+
+// The pipeline writes asynchronously, give it some time to catch up.
+static std::string WaitForNode(const FakeRoot& root, const std::string& expected) {
+    std::string contents;
+    for (int i = 0; i < 100; i++) {
+        contents = root.ReadFile(kColorNode);
+        if (contents == expected) break;
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return contents;
+}
+
+TEST(LiveDisplayTest, UnsupportedWithoutNode) {
+    FakeRoot root;
+    auto pipeline = std::make_shared<ColorPipeline>();
+
+    EXPECT_FALSE(ndk::SharedRefBase::make<DisplayColorCalibration>(pipeline)->isSupported());
+    EXPECT_FALSE(ndk::SharedRefBase::make<DisplayModes>(pipeline)->isSupported());
+    EXPECT_FALSE(ndk::SharedRefBase::make<PictureAdjustment>(pipeline)->isSupported());
+}
+
+TEST(LiveDisplayTest, CalibrationSurvivesRestarts) {
+    FakeRoot root;
+    ASSERT_TRUE(root.WriteFile(kColorNode, "1,2,3,4,5,6,7,8,9\n"));
+
+    const std::string calibrated = ColorMatrix::diagonal(32768, 30000, 20000).toString();
+
+    // Every restart has to end up with the same matrix, and must never
+    // take the composed matrix on the panel for the calibration.
+    for (int restart = 0; restart < 3; restart++) {
+        auto pipeline = std::make_shared<ColorPipeline>();
+        auto dcc = ndk::SharedRefBase::make<DisplayColorCalibration>(pipeline);
+        auto modes = ndk::SharedRefBase::make<DisplayModes>(pipeline);
+        ASSERT_TRUE(dcc->isSupported());
+
+        if (restart == 0) {
+            ASSERT_TRUE(dcc->setCalibration({32768, 30000, 20000}).isOk());
+        }
+
+        std::vector<int32_t> rgb;
+        ASSERT_TRUE(dcc->getCalibration(&rgb).isOk());
+        EXPECT_EQ((std::vector<int32_t>{32768, 30000, 20000}), rgb);
+        EXPECT_EQ(calibrated, WaitForNode(root, calibrated));
+    }
+}
+
+TEST(LiveDisplayTest, IntensityAndContrastOnlyGoDown) {
+    FakeRoot root;
+    ASSERT_TRUE(root.WriteFile(kColorNode, "32768,0,0,0,32768,0,0,0,32768\n"));
+
+    auto pipeline = std::make_shared<ColorPipeline>();
+    auto pa = ndk::SharedRefBase::make<PictureAdjustment>(pipeline);
+
+    FloatRange range;
+    ASSERT_TRUE(pa->getIntensityRange(&range).isOk());
+    EXPECT_EQ(0.0f, range.max);
+    ASSERT_TRUE(pa->getContrastRange(&range).isOk());
+    EXPECT_EQ(0.0f, range.max);
+
+    HSIC hsic;
+    hsic.intensity = 10;
+    EXPECT_EQ(EX_ILLEGAL_ARGUMENT, pa->setPictureAdjustment(hsic).getExceptionCode());
+
+    hsic.intensity = -50;
+    ASSERT_TRUE(pa->setPictureAdjustment(hsic).isOk());
+
+    const std::string halved = ColorMatrix::gain(0.5f).toString();
+    EXPECT_EQ(halved, WaitForNode(root, halved));
+}
+
+TEST(LiveDisplayTest, LastUpdateSurvivesDestruction) {
+    FakeRoot root;
+    ASSERT_TRUE(root.WriteFile(kColorNode, "32768,0,0,0,32768,0,0,0,32768\n"));
+
+    {
+        auto pipeline = std::make_shared<ColorPipeline>();
+        pipeline->setAdjustment(ColorMatrix::gain(0.5f));
+    }
+
+    EXPECT_EQ(ColorMatrix::gain(0.5f).toString(), root.ReadFile(kColorNode));
+}
+
+TEST(LiveDisplayTest, ModesKeepWhite) {
+    FakeRoot root;
+    ASSERT_TRUE(root.WriteFile(kColorNode, "32768,0,0,0,32768,0,0,0,32768\n"));
+
+    std::vector<DisplayMode> list;
+    ASSERT_TRUE(ndk::SharedRefBase::make<DisplayModes>(std::make_shared<ColorPipeline>())
+                        ->getDisplayModes(&list)
+                        .isOk());
+
+    // A mode that needs coefficients above 1.0 gets scaled down by the
+    // pipeline, which dims white instead of changing the colors.
+    for (const auto& mode : list) {
+        {
+            // The pipeline writes out the last matrix when it goes away.
+            auto pipeline = std::make_shared<ColorPipeline>();
+            ASSERT_TRUE(ndk::SharedRefBase::make<DisplayModes>(pipeline)
+                                ->setDisplayMode(mode.id, false)
+                                .isOk());
+        }
+
+        std::vector<std::string> values = android::base::Split(root.ReadFile(kColorNode), ",");
+        ASSERT_EQ(9, values.size());
+        for (int row = 0; row < 3; row++) {
+            int sum = 0;
+            for (int col = 0; col < 3; col++) sum += std::stoi(values[row * 3 + col]);
+            EXPECT_NEAR(ColorMatrix::kOne, sum, 3) << mode.name;
+        }
+    }
+}
+
+TEST(LiveDisplayTest, ConcurrentAdjustmentsMatchPanel) {
+    FakeRoot root;
+    ASSERT_TRUE(root.WriteFile(kColorNode, "32768,0,0,0,32768,0,0,0,32768\n"));
+
+    auto pipeline = std::make_shared<ColorPipeline>();
+    auto pa = ndk::SharedRefBase::make<PictureAdjustment>(pipeline);
+
+    std::vector<std::thread> callers;
+    for (int i = 0; i < 8; i++) {
+        callers.emplace_back([&pa, i] {
+            HSIC hsic;
+            hsic.intensity = -5.0f * i;
+            for (int round = 0; round < 100; round++) pa->setPictureAdjustment(hsic);
+        });
+    }
+    for (auto& caller : callers) caller.join();
+
+    // Whichever call won, the panel must show the one that is reported.
+    HSIC hsic;
+    ASSERT_TRUE(pa->getPictureAdjustment(&hsic).isOk());
+    const std::string expected = ColorMatrix::gain(1 + hsic.intensity / 100).toString();
+    EXPECT_EQ(expected, WaitForNode(root, expected));
+}
@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2024 The LineageOS Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <gtest/gtest.h>
+
+#include <hisi_fake_root.h>
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "TouchscreenGesture.h"
+
+using ::aidl::vendor::lineage::touch::Gesture;
+using ::aidl::vendor::lineage::touch::TouchscreenGesture;
+
+static constexpr const char* kGestureNode = "/sys/touchscreen/easy_wakeup_gesture";
+
+TEST(TouchscreenGestureTest, UnsupportedWithoutNode) {
+    FakeRoot root;
+
+    EXPECT_FALSE(ndk::SharedRefBase::make<TouchscreenGesture>()->isSupported());
+}
+
+TEST(TouchscreenGestureTest, ConcurrentCallersEndWithFullMask) {
+    FakeRoot root;
+    ASSERT_TRUE(root.WriteFile(kGestureNode, "0x0000\n"));
+
+    auto tg = ndk::SharedRefBase::make<TouchscreenGesture>();
+    ASSERT_TRUE(tg->isSupported());
+
+    std::vector<Gesture> gestures;
+    ASSERT_TRUE(tg->getSupportedGestures(&gestures).isOk());
+    ASSERT_EQ(4, gestures.size());
+
+    // Every caller flips all gestures a few times and leaves them on.
+    std::vector<std::thread> callers;
+    for (int i = 0; i < 8; i++) {
+        callers.emplace_back([&tg, &gestures] {
+            for (int round = 0; round < 100; round++) {
+                for (const auto& gesture : gestures) {
+                    tg->setGestureEnabled(gesture, round % 2 == 0);
+                }
+            }
+            for (const auto& gesture : gestures) tg->setGestureEnabled(gesture, true);
+        });
+    }
+    for (auto& caller : callers) caller.join();
+
+    ASSERT_TRUE(tg->flush());
+    EXPECT_EQ(std::to_string(0x780), root.ReadFile(kGestureNode));
+}
+
+TEST(TouchscreenGestureTest, BurstIsDeferred) {
+    FakeRoot root;
+    ASSERT_TRUE(root.WriteFile(kGestureNode, "0x0000\n"));
+
+    // A window no test run can outlast, so nothing is written on its own.
+    auto tg = ndk::SharedRefBase::make<TouchscreenGesture>(std::chrono::hours(1));
+    std::vector<Gesture> gestures;
+    ASSERT_TRUE(tg->getSupportedGestures(&gestures).isOk());
+
+    for (const auto& gesture : gestures) ASSERT_TRUE(tg->setGestureEnabled(gesture, true).isOk());
+    EXPECT_EQ("0x0000\n", root.ReadFile(kGestureNode));
+
+    ASSERT_TRUE(tg->flush());
+    EXPECT_EQ(std::to_string(0x780), root.ReadFile(kGestureNode));
+}
+
+TEST(TouchscreenGestureTest, SteadyStreamIsWrittenEventually) {
+    FakeRoot root;
+    ASSERT_TRUE(root.WriteFile(kGestureNode, "0x0000\n"));
+
+    auto tg = ndk::SharedRefBase::make<TouchscreenGesture>(std::chrono::milliseconds(20));
+    std::vector<Gesture> gestures;
+    ASSERT_TRUE(tg->getSupportedGestures(&gestures).isOk());
+
+    // Toggles keep coming faster than the window, the write must still
+    // go out once the total deferral runs out. Slower toggles only make
+    // it go out sooner.
+    auto give_up = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    for (int i = 0; root.ReadFile(kGestureNode) == "0x0000\n"; i++) {
+        ASSERT_LT(std::chrono::steady_clock::now(), give_up);
+        tg->setGestureEnabled(gestures[i % gestures.size()], true);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2024 The LineageOS Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+// Just enough of the NDK binder API for the HAL implementations to build
+// and run on the host, without a binder driver or service manager.
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+enum {
+    EX_NONE = 0,
+    EX_ILLEGAL_ARGUMENT = -3,
+    EX_ILLEGAL_STATE = -5,
+    EX_UNSUPPORTED_OPERATION = -7,
+};
+
+enum {
+    STATUS_OK = 0,
+    STATUS_UNKNOWN_ERROR = -2147483647 - 1,
+};
+
+struct AIBinder;
+
+namespace ndk {
+
+class ScopedAStatus {
+  public:
+    static ScopedAStatus ok() { return ScopedAStatus(EX_NONE); }
+    static ScopedAStatus fromExceptionCode(int32_t exception) { return ScopedAStatus(exception); }
+
+    bool isOk() const { return mException == EX_NONE; }
+    int32_t getExceptionCode() const { return mException; }
+
+  private:
+    explicit ScopedAStatus(int32_t exception) : mException(exception) {}
+
+    int32_t mException;
+};
+
+class SpAIBinder {
+  public:
+    AIBinder* get() const { return nullptr; }
+};
+
+class SharedRefBase : public std::enable_shared_from_this<SharedRefBase> {
+  public:
+    virtual ~SharedRefBase() = default;
+
+    template <class T, class... Args>
+    static std::shared_ptr<T> make(Args&&... args) {
+        return std::make_shared<T>(std::forward<Args>(args)...);
+    }
+};
+
+class ICInterface : public SharedRefBase {
+  public:
+    SpAIBinder asBinder() { return {}; }
+};
+
+template <typename INTERFACE>
+class BnCInterface : public INTERFACE {};
+
+}  // namespace ndk
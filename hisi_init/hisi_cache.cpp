@@ -0,0 +1,161 @@
+/*
+ * Copyright (C) 2024 The LineageOS Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#define LOG_TAG "hisi_cache"
+
+#include "include/hisi_cache.h"
+
+#include <android-base/file.h>
+#include <android-base/logging.h>
+#include <android-base/unique_fd.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using android::base::unique_fd;
+
+constexpr uint32_t kCacheMagic = 0x43564e48;  // "HNVC"
+constexpr uint32_t kCacheVersion = 1;
+
+// Only this much of the partition is hashed for the fingerprint.
+constexpr size_t kFingerprintRegion = 64 * 1024;
+
+static uint64_t fnv1a(const void* data, size_t size, uint64_t hash = 0xcbf29ce484222325ull) {
+    auto bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+bool compute_fingerprint(const std::string& path, partition_fingerprint_t* fingerprint) {
+    unique_fd fd(open(path.c_str(), O_RDONLY | O_CLOEXEC));
+    if (fd == -1) {
+        LOG(ERROR) << "Unable to open " << path << ", error: " << strerror(errno);
+        return false;
+    }
+
+    off_t size = lseek(fd, 0, SEEK_END);
+    if (size <= 0) return false;
+
+    std::vector<char> buffer(std::min<size_t>(size, kFingerprintRegion));
+    if (!android::base::ReadFullyAtOffset(fd, buffer.data(), buffer.size(), 0)) {
+        LOG(ERROR) << "Unable to read " << path << ", error: " << strerror(errno);
+        return false;
+    }
+
+    fingerprint->size = static_cast<uint64_t>(size);
+    fingerprint->hash = fnv1a(buffer.data(), buffer.size());
+    return true;
+}
+
+// The cache file layout is as follows, all integers in host order:
+//   u32 magic, u32 version, u64 size, u64 hash, u32 count,
+//   count * (u32 key length, key, u32 value length, value),
+//   u64 hash of everything above.
+template <typename T>
+static void append(std::string* out, const T& value) {
+    out->append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template <typename T>
+static bool consume(const std::string& in, size_t* offset, T* value) {
+    if (in.size() - *offset < sizeof(T)) return false;
+    std::memcpy(value, in.data() + *offset, sizeof(T));
+    *offset += sizeof(T);
+    return true;
+}
+
+static bool consume_string(const std::string& in, size_t* offset, std::string* value) {
+    uint32_t length;
+    if (!consume(in, offset, &length) || in.size() - *offset < length) return false;
+    value->assign(in, *offset, length);
+    *offset += length;
+    return true;
+}
+
+bool BootCache::Load(const partition_fingerprint_t& fingerprint,
+                     std::unordered_map<std::string, std::string>* values) const {
+    std::string contents;
+    if (!android::base::ReadFileToString(mPath, &contents)) return false;
+
+    // Make sure the file wasn't truncated or otherwise damaged.
+    uint64_t checksum;
+    if (contents.size() < sizeof(checksum)) return false;
+
+    size_t body = contents.size() - sizeof(checksum);
+    std::memcpy(&checksum, contents.data() + body, sizeof(checksum));
+    if (checksum != fnv1a(contents.data(), body)) {
+        LOG(WARNING) << "Ignoring corrupted cache " << mPath;
+        return false;
+    }
+    contents.resize(body);
+
+    size_t offset = 0;
+    uint32_t magic, version, count;
+    partition_fingerprint_t stored;
+    if (!consume(contents, &offset, &magic) || magic != kCacheMagic ||
+        !consume(contents, &offset, &version) || version != kCacheVersion ||
+        !consume(contents, &offset, &stored.size) || !consume(contents, &offset, &stored.hash) ||
+        !consume(contents, &offset, &count)) {
+        return false;
+    }
+
+    // The partition changed since the cache was written.
+    if (!(stored == fingerprint)) return false;
+
+    std::unordered_map<std::string, std::string> result;
+    for (uint32_t i = 0; i < count; ++i) {
+        std::string key, value;
+        if (!consume_string(contents, &offset, &key) ||
+            !consume_string(contents, &offset, &value)) {
+            return false;
+        }
+        result.emplace(std::move(key), std::move(value));
+    }
+
+    *values = std::move(result);
+    return true;
+}
+
+bool BootCache::Store(const partition_fingerprint_t& fingerprint,
+                      const std::unordered_map<std::string, std::string>& values) const {
+    std::string contents;
+
+    append(&contents, kCacheMagic);
+    append(&contents, kCacheVersion);
+    append(&contents, fingerprint.size);
+    append(&contents, fingerprint.hash);
+    append(&contents, static_cast<uint32_t>(values.size()));
+
+    for (const auto& [key, value] : values) {
+        append(&contents, static_cast<uint32_t>(key.size()));
+        contents += key;
+        append(&contents, static_cast<uint32_t>(value.size()));
+        contents += value;
+    }
+
+    append(&contents, fnv1a(contents.data(), contents.size()));
+
+    // Write to a temporary file first, so that a crash half way
+    // through never leaves a partially written cache behind.
+    std::string tmp = mPath + ".tmp";
+    if (!android::base::WriteStringToFile(contents, tmp) || rename(tmp.c_str(), mPath.c_str())) {
+        LOG(ERROR) << "Unable to write " << mPath << ", error: " << strerror(errno);
+        unlink(tmp.c_str());
+        return false;
+    }
+
+    return true;
+}
@@ -9,21 +9,30 @@
 #include "include/hisi_connectivity.h"
 #include "include/hisi_utils.h"
 
+#include <hisi_cmdline.h>
+#include <hisi_paths.h>
+#include <hisi_trace.h>
+
 #include <android-base/file.h>
 #include <android-base/logging.h>
-#include <android-base/strings.h>
 
+#include <ctype.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <unistd.h>
 #include <algorithm>
 #include <fstream>
 #include <string>
+#include <string_view>
 
 constexpr const char* kChiptypePath = "/proc/connectivity/chiptype";
 constexpr const char* kDeviceTreePath = "/proc/device-tree";
 constexpr const char* kPropSubChipType = "ro.connectivity.sub_chiptype";
 constexpr const char* kPropChipType = "ro.connectivity.chiptype";
 
-constexpr const char* kCmdline = "/proc/cmdline";
 constexpr const char* kDefaultId = "0X00000000";
 constexpr const char* kPropRilReady = "sys.rilprops_ready";
 
@@ -40,57 +49,153 @@ constexpr const char* kPhonePropPaths[] = {
 
 std::string ReadProductId() {
     std::string prid = kDefaultId;
-    std::string cmdline;
-
-    if (android::base::ReadFileToString(kCmdline, &cmdline)) {
-        for (const auto& i : android::base::Split(android::base::Trim(cmdline), " ")) {
-            std::vector<std::string> parts = android::base::Split(i, "=");
-            if (parts.size() == 2 && parts.at(0) == "productid") {
-                prid = parts.at(1);
-                std::transform(prid.begin(), prid.end(), prid.begin(),
-                               [](unsigned char c) { return toupper(c); });
-            }
-        }
+    ScopedStageTrace trace("connectivity.cmdline");
+
+    if (auto value = kernel_cmdline().Get("productid"); value && !value->empty()) {
+        prid = std::string(*value);
+        std::transform(prid.begin(), prid.end(), prid.begin(),
+                       [](unsigned char c) { return toupper(c); });
     }
 
     return prid;
 }
 
-static int SetPhoneProperties(std::string prid, std::string propFile) {
-    int ret = -1;
-    std::string line;
-    std::ifstream file(propFile);
-
-    if (file.is_open()) {
-        while (std::getline(file, line)) {
-            if (ret == 0 && line.length() == 0) break;
-            if (line.find(prid) != std::string::npos) ret = 0;
-
-            if (ret == 0) {
-                std::vector<std::string> parts = android::base::Split(line, "=");
-                if (parts.size() == 2) {
-                    if (std::find(std::begin(kDenylistedProperties),
-                                  std::end(kDenylistedProperties),
-                                  parts.at(0)) == std::end(kDenylistedProperties)) {
-                        set_property(parts.at(0), parts.at(1));
-                    }
-                }
-            }
+// Extracts the product id (i.e. "0X003E4E00") from a section header,
+// or returns the whole header if it doesn't contain one.
+static std::string_view SectionKey(std::string_view header) {
+    size_t start = header.find("0X");
+    if (start == std::string_view::npos) return header;
+
+    size_t end = start + 2;
+    while (end < header.size() && isxdigit(static_cast<unsigned char>(header[end]))) ++end;
+
+    return header.substr(start, end - start);
+}
+
+PhonePropFile::PhonePropFile(const std::string& path) {
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1) return;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        close(fd);
+        return;
+    }
+
+    void* data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if (data == MAP_FAILED) {
+        LOG(ERROR) << "Unable to map " << path << ", error: " << strerror(errno);
+        return;
+    }
+
+    mData = static_cast<char*>(data);
+    mSize = static_cast<size_t>(st.st_size);
+
+    BuildIndex();
+}
+
+PhonePropFile::~PhonePropFile() {
+    if (mData != nullptr) munmap(mData, mSize);
+}
+
+void PhonePropFile::BuildIndex() {
+    std::string_view contents(mData, mSize);
+    bool section_start = true;
+
+    // Only the first line of every section is looked at here.
+    for (size_t offset = 0; offset < contents.size();) {
+        size_t eol = contents.find('\n', offset);
+        if (eol == std::string_view::npos) eol = contents.size();
+
+        std::string_view line = contents.substr(offset, eol - offset);
+        if (line.empty()) {
+            section_start = true;
+        } else if (section_start) {
+            mSections.push_back({SectionKey(line), line, offset});
+            section_start = false;
         }
+
+        offset = eol + 1;
     }
 
-    return ret;
+    std::stable_sort(mSections.begin(), mSections.end(),
+                     [](const SectionInfo& a, const SectionInfo& b) { return a.key < b.key; });
+}
+
+std::string_view PhonePropFile::FindSection(const std::string& prid) const {
+    std::string_view contents(mData, mSize);
+    auto it = std::lower_bound(
+            mSections.begin(), mSections.end(), prid,
+            [](const SectionInfo& section, const std::string& key) { return section.key < key; });
+
+    if (it == mSections.end() || it->key != prid) {
+        // Headers that don't follow the usual format are not keyed
+        // by the product id, so fall back to scanning the headers.
+        it = std::find_if(mSections.begin(), mSections.end(), [&prid](const SectionInfo& section) {
+            return section.header.find(prid) != std::string_view::npos;
+        });
+        if (it == mSections.end()) return {};
+    }
+
+    size_t end = contents.find("\n\n", it->offset);
+    if (end == std::string_view::npos) end = contents.size();
+
+    return contents.substr(it->offset, end - it->offset);
+}
+
+static int SetPhoneProperties(const std::string& prid, const std::string& propFile,
+                              PropertyBatch* batch) {
+    ScopedStageTrace trace("connectivity.phone_prop_parse");
+    PhonePropFile file(propFile);
+    if (!file.IsValid()) return -1;
+
+    std::string_view section = file.FindSection(prid);
+    if (section.empty()) return -1;
+
+    for (size_t offset = 0; offset < section.size();) {
+        size_t eol = section.find('\n', offset);
+        if (eol == std::string_view::npos) eol = section.size();
+
+        std::string_view line = section.substr(offset, eol - offset);
+        offset = eol + 1;
+
+        // Only lines with exactly one '=' are properties.
+        size_t separator = line.find('=');
+        if (separator == std::string_view::npos ||
+            line.find('=', separator + 1) != std::string_view::npos) {
+            continue;
+        }
+
+        std::string_view name = line.substr(0, separator);
+        if (std::find(std::begin(kDenylistedProperties), std::end(kDenylistedProperties), name) ==
+            std::end(kDenylistedProperties)) {
+            batch->Set(std::string(name), std::string(line.substr(separator + 1)));
+        }
+    }
+
+    return 0;
 }
 
 static int LoadPhoneProperties() {
     int ret = -1;
+    SystemPropertyBackend backend;
+    PropertyBatch batch(&backend, "phone.prop");
 
     std::string productId = ReadProductId();
     if (productId != kDefaultId) {
         for (const auto& path : kPhonePropPaths) {
-            if ((ret = SetPhoneProperties(productId, path)) == 0) {
+            if ((ret = SetPhoneProperties(productId, hisi_path(path), &batch)) == 0) {
                 LOG(INFO) << "Successfully loaded phone properties ( " << path << ") for "
                           << productId;
+
+                // RIL must only see the ready flag after every phone
+                // property has actually been published.
+                {
+                    ScopedStageTrace trace("connectivity.property_commit");
+                    batch.Commit();
+                }
                 set_property(kPropRilReady, "1");
                 return ret;
             }
@@ -101,13 +206,14 @@ static int LoadPhoneProperties() {
 }
 
 static int LoadChipProperties() {
+    ScopedStageTrace trace("connectivity.chip");
     int ret = -1;
     std::string chip_type;
     std::string subchip_path;
 
     // This is the main chip type, and it can be used to determine the hardware
     // revision. In our case, we can have either hisi or bcm.
-    if (!android::base::ReadFileToString(kChiptypePath, &chip_type)) {
+    if (!android::base::ReadFileToString(hisi_path(kChiptypePath), &chip_type)) {
         LOG(ERROR) << "Unable to read: " << kChiptypePath;
         return ret;
     }
@@ -118,12 +224,12 @@ static int LoadChipProperties() {
     // This is the subchip type, and it may be different depending on the hardware
     // revision. In our case, we can have either hi11xx or bcm43xx.
     if (chip_type.find("hisi") == 0) {
-        subchip_path = std::string(kDeviceTreePath) + "/hi110x/hi110x,subchip_type";
+        subchip_path = hisi_path(kDeviceTreePath) + "/hi110x/hi110x,subchip_type";
         if (access(subchip_path.c_str(), F_OK) != 0) {
-            subchip_path = std::string(kDeviceTreePath) + "/hi1102/name";
+            subchip_path = hisi_path(kDeviceTreePath) + "/hi1102/name";
         }
     } else {
-        subchip_path = std::string(kDeviceTreePath) + "/bcm_wifi/ic_type";
+        subchip_path = hisi_path(kDeviceTreePath) + "/bcm_wifi/ic_type";
     }
 
     if (!android::base::ReadFileToString(subchip_path, &chip_type)) {
@@ -8,12 +8,35 @@
 
 #include "include/hisi_connectivity.h"
 #include "include/hisi_nve.h"
+#include "include/hisi_utils.h"
+
+#include <hisi_trace.h>
 
 #include <android-base/logging.h>
 
+#include <stdlib.h>
+
+constexpr const char* kPropBootTiming = "vendor.hisi_init.boot_timing";
+
 int main() {
-    LOG(INFO) << "Running hisi_connectivity";
-    load_hisi_connectivity();
-    LOG(INFO) << "Running hisi_nve";
-    load_hisi_nve();
+    // The connectivity stage only touches procfs, the device tree and
+    // phone.prop, while the NVE stage only reads the NVE partition, so
+    // neither has to wait for the other. Each stage publishes its own
+    // ready property once it is done.
+    run_stages({
+            {"hisi_connectivity", load_hisi_connectivity},
+            {"hisi_nve", load_hisi_nve},
+    });
+
+    // Publish how long every stage took, so boot regressions show up
+    // without having to capture a trace.
+    std::string summary = trace_summary();
+    LOG(INFO) << "Boot timing: " << summary;
+    set_property(kPropBootTiming, summary);
+
+#ifndef __ANDROID__
+    // hisi_init_host runs against a fake root, so the numbers are
+    // written out for comparing runs rather than published.
+    if (const char* path = getenv("HISI_TRACE_JSON"); path != nullptr) trace_write_json(path);
+#endif
 }
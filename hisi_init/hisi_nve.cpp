@@ -7,14 +7,26 @@
 #define LOG_TAG "hisi_nve"
 
 #include "include/hisi_nve.h"
+#include "include/hisi_cache.h"
+
+#include <hisi_paths.h>
+#include <hisi_search.h>
+#include <hisi_trace.h>
 
 #include <android-base/logging.h>
 #include <android-base/properties.h>
 
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
 #include <cstring>
 #include <fstream>
 #include <iostream>
 #include <string>
+#include <string_view>
 #include <vector>
 
 template <typename T>
@@ -39,9 +51,9 @@ std::string parse_mac(const std::string& mac) {
 std::string load_nve_path() {
     // Loop over all the possible paths and use
     // the first one that exists and can be read.
-    for (const auto& path : kNvePaths) {
+    for (const auto& nve_path : kNvePaths) {
         // Make sure the path is accessible for us.
-        if (access(path.c_str(), R_OK) == 0) return path;
+        if (std::string path = hisi_path(nve_path); access(path.c_str(), R_OK) == 0) return path;
     }
 
     // If we reached this point, we couldn't find
@@ -50,69 +62,93 @@ std::string load_nve_path() {
     return "";
 }
 
-std::streampos find_start_offset(std::ifstream& file) {
-    if (!file.is_open()) return std::streampos(-1);
+size_t find_start_offset(const char* data, size_t size) {
+    constexpr std::string_view kAnchor = "SWVERSI";
 
-    file.seekg(0, std::ios::end);
-    std::streampos file_size = file.tellg();
-    file.seekg(0, std::ios::beg);
+    return find_pattern(data, size, kAnchor.data(), kAnchor.size());
+}
 
-    const size_t bufferSize = 4096;
-    char buffer[bufferSize];
+NveImage::NveImage(const std::string& path) {
+    ScopedStageTrace trace("nve.open");
 
-    for (std::streampos i = 0; i < file_size; i += bufferSize - 7) {
-        file.seekg(i);
-        file.read(buffer, bufferSize);
-        for (size_t j = 0; j < bufferSize - 7; ++j) {
-            if (std::memcmp(buffer + j, "SWVERSI", 7) == 0) {
-                return i + static_cast<std::streampos>(j);
-            }
-        }
+    // The caller is supposed to pass the path to the NVE
+    // partition block. Make sure it can actually be read.
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1) {
+        LOG(ERROR) << "Unable to open " << path << ", error: " << strerror(errno);
+        return;
     }
-    return std::streampos(-1);
-}
 
-std::string nve_read(const std::string& name, const std::string& path) {
-    // The caller is supposed to pass the path to the NVE
-    // partition block and the name of the entry to read.
-    nv_item entry;
-    std::ifstream file(path, std::ios::binary);
-
-    // This shouldn't be required but make sure the path
-    // the caller passed is valid and the file can be read.
-    if (!file.is_open()) {
-        // If we can't open the file, return an empty string
-        // and let the caller handle the situation.
-        LOG(ERROR) << "Unable to open " << path;
-        return "";
+    off_t size = lseek(fd, 0, SEEK_END);
+    if (size <= 0) {
+        LOG(ERROR) << "Unable to determine the size of " << path;
+        close(fd);
+        return;
+    }
+
+    void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if (data == MAP_FAILED) {
+        LOG(ERROR) << "Unable to map " << path << ", error: " << strerror(errno);
+        return;
     }
 
+    mData = data;
+    mSize = static_cast<size_t>(size);
+
     // The next step is to find the start offset of the NVE
     // partition. This is done by searching for the "SWVERSI"
     // string and then going back 4 bytes.
-    std::streampos start_offset = find_start_offset(file);
-    if (start_offset == std::streampos(-1)) {
-        // If we can't find the start offset, return an empty
-        // string and let the caller handle the situation.
+    ScopedStageTrace scan_trace("nve.anchor_scan");
+    size_t start_offset = find_start_offset(static_cast<const char*>(mData), mSize);
+    if (start_offset == kPatternNotFound || start_offset < 4) {
         LOG(ERROR) << "Unable to find the start offset of the NVE partition";
-        return "";
+        return;
     }
 
-    // Now that we know the start offset, we can seek to it
-    // and start reading the entries.
-    file.seekg(start_offset - static_cast<std::streamoff>(4));
-    while (file.read(reinterpret_cast<char*>(&entry), sizeof(nv_item))) {
-        if (std::memcmp(entry.nv_name, name.c_str(), name.length()) == 0) {
-            // If the entry name starts with "MAC", we need to add
-            // a colon between each byte of the MAC address.
-            return std::string(entry.nv_data, entry.valid_size);
-        }
+    mStart = start_offset - 4;
+}
+
+NveImage::~NveImage() {
+    if (mData != nullptr) munmap(mData, mSize);
+}
+
+std::unordered_map<std::string, std::string> NveImage::Read(
+        const std::vector<std::string>& names) const {
+    std::unordered_map<std::string, std::string> result;
+    if (!IsValid()) return result;
+
+    ScopedStageTrace trace("nve.read");
+
+    auto base = static_cast<const char*>(mData);
+
+    // Walk the entry table once, in order. Only the first entry
+    // with a given name counts, just like a lookup by name would.
+    for (size_t offset = mStart; offset + sizeof(nv_item) <= mSize; offset += sizeof(nv_item)) {
+        auto entry = reinterpret_cast<const nv_item*>(base + offset);
+        std::string_view name(entry->nv_name, strnlen(entry->nv_name, sizeof(entry->nv_name)));
+
+        if (std::find(names.begin(), names.end(), name) == names.end()) continue;
+        if (result.count(std::string(name)) != 0) continue;
+
+        result.emplace(name, std::string(entry->nv_data, std::min<size_t>(entry->valid_size,
+                                                                          sizeof(entry->nv_data))));
+
+        // Stop early once we have everything the caller asked for.
+        if (result.size() == names.size()) break;
     }
 
-    // If we reached this point, we couldn't find the entry
-    // the caller was looking for. Return an empty string
-    // and let the caller handle the situation.
-    return "";
+    return result;
+}
+
+std::string NveImage::Read(const std::string& name) const {
+    auto result = Read(std::vector<std::string>{name});
+    auto it = result.find(name);
+
+    // If we couldn't find the entry the caller was looking for,
+    // return an empty string and let the caller handle it.
+    return it != result.end() ? it->second : "";
 }
 
 int LoadNveProperties() {
@@ -122,11 +158,51 @@ int LoadNveProperties() {
         return -1;
     }
 
+    std::vector<std::string> names;
+    for (const auto& pair : kNveMacMap) names.push_back(pair.first);
+
+    // The NVE partition rarely changes, so try to reuse what we
+    // extracted from it on a previous boot before parsing it again.
+    std::unordered_map<std::string, std::string> entries;
+    partition_fingerprint_t fingerprint = {};
+    BootCache cache(hisi_path(kNveCachePath));
+
+    auto has_all_names = [&names](const std::unordered_map<std::string, std::string>& map) {
+        return std::all_of(names.begin(), names.end(),
+                           [&map](const std::string& name) { return map.count(name) != 0; });
+    };
+
+    bool cached;
+    {
+        ScopedStageTrace trace("nve.cache_load");
+        cached = compute_fingerprint(path, &fingerprint) && cache.Load(fingerprint, &entries) &&
+                 has_all_names(entries);
+    }
+
+    if (cached) {
+        LOG(INFO) << "Using cached NVE entries from " << kNveCachePath;
+    } else {
+        NveImage image(path);
+        if (!image.IsValid()) {
+            LOG(ERROR) << "Unable to index the NVE partition at " << path;
+            return -1;
+        }
+
+        // Every entry we care about is read in a single pass.
+        entries = image.Read(names);
+
+        // Remember missing entries too, so they don't force a full
+        // parse on every boot. They are stored as empty values.
+        for (const auto& name : names) entries.try_emplace(name);
+
+        if (fingerprint.size != 0) cache.Store(fingerprint, entries);
+    }
+
     for (const auto& pair : kNveMacMap) {
-        if (std::string mac_value = nve_read(pair.first, path); mac_value.empty()) {
+        if (auto it = entries.find(pair.first); it == entries.end() || it->second.empty()) {
             LOG(WARNING) << "Unable to read " << pair.first << " from NVE partition";
         } else {
-            set(pair.second, parse_mac(mac_value));
+            set(hisi_path(pair.second), parse_mac(it->second));
         }
     }
 
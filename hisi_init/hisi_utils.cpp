@@ -8,12 +8,19 @@
 
 #include "include/hisi_utils.h"
 
+#include <hisi_trace.h>
+
 #include <android-base/logging.h>
 #include <android-base/properties.h>
 
 #include <string>
+#include <thread>
 #include <vector>
 
+bool SystemPropertyBackend::Set(const std::string& name, const std::string& value) {
+    return android::base::SetProperty(name, value);
+}
+
 void set_property(const std::string& prop, const std::string& value) {
     LOG(INFO) << "Setting property: " << prop << " to " << value;
 
@@ -21,3 +28,20 @@ void set_property(const std::string& prop, const std::string& value) {
         LOG(ERROR) << "Unable to set: " << prop << " to " << value;
     }
 }
+
+void run_stages(const std::vector<hisi_stage_t>& stages) {
+    std::vector<std::thread> threads;
+    ScopedStageTrace trace("hisi_init");
+
+    threads.reserve(stages.size());
+    for (const auto& stage : stages) {
+        threads.emplace_back([&stage]() {
+            ScopedStageTrace trace(stage.name);
+
+            LOG(INFO) << "Running " << stage.name;
+            stage.run();
+        });
+    }
+
+    for (auto& thread : threads) thread.join();
+}
@@ -0,0 +1,42 @@
+/*
+ * Copyright (C) 2024 The LineageOS Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+constexpr const char* kNveCachePath = "/data/vendor/hisi_init/nve.cache";
+
+// Identifies the contents of a partition without reading all of it:
+// the size of the partition and a hash of its leading region.
+typedef struct partition_fingerprint {
+    uint64_t size;
+    uint64_t hash;
+
+    bool operator==(const partition_fingerprint& other) const {
+        return size == other.size && hash == other.hash;
+    }
+} partition_fingerprint_t;
+
+bool compute_fingerprint(const std::string& path, partition_fingerprint_t* fingerprint);
+
+// A small on-disk cache of values extracted from a partition. The
+// values are only handed out if the fingerprint they were stored with
+// still matches, anything else is treated as a cache miss.
+class BootCache {
+  public:
+    explicit BootCache(const std::string& path) : mPath(path) {}
+
+    bool Load(const partition_fingerprint_t& fingerprint,
+              std::unordered_map<std::string, std::string>* values) const;
+    bool Store(const partition_fingerprint_t& fingerprint,
+               const std::unordered_map<std::string, std::string>& values) const;
+
+  private:
+    std::string mPath;
+};
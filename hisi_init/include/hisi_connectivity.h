@@ -6,4 +6,42 @@
 
 #pragma once
 
+#include <string>
+#include <string_view>
+#include <vector>
+
+// A read-only view of a phone.prop file. Sections are separated by
+// empty lines and start with a header line naming the product id.
+// The file is mapped once and every section header is recorded in a
+// sorted index, so finding a product's section is a binary search
+// and the other sections are never tokenized.
+class PhonePropFile {
+  public:
+    explicit PhonePropFile(const std::string& path);
+    ~PhonePropFile();
+
+    PhonePropFile(const PhonePropFile&) = delete;
+    PhonePropFile& operator=(const PhonePropFile&) = delete;
+
+    bool IsValid() const { return mData != nullptr; }
+
+    // Returns the section for the given product id, from its header
+    // line up to (not including) the next empty line, or an empty
+    // view if there is none.
+    std::string_view FindSection(const std::string& prid) const;
+
+  private:
+    typedef struct {
+        std::string_view key;
+        std::string_view header;
+        size_t offset;
+    } SectionInfo;
+
+    void BuildIndex();
+
+    char* mData = nullptr;
+    size_t mSize = 0;
+    std::vector<SectionInfo> mSections;
+};
+
 void load_hisi_connectivity();
@@ -6,6 +6,7 @@
 #pragma once
 
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -38,4 +39,31 @@ const std::vector<std::string> kNvePaths = {
         "/dev/block/mmcblk0p7",
 };
 
+// A read-only view of the NVE partition. The partition is mapped
+// and the start of the entry table is located only once, however
+// many entries are read from it.
+class NveImage {
+  public:
+    explicit NveImage(const std::string& path);
+    ~NveImage();
+
+    NveImage(const NveImage&) = delete;
+    NveImage& operator=(const NveImage&) = delete;
+
+    bool IsValid() const { return mStart != kInvalidOffset; }
+
+    // Looks up all the given names in a single walk of the entry
+    // table, which stops as soon as every name has been found.
+    // Names that don't exist are left out of the result.
+    std::unordered_map<std::string, std::string> Read(const std::vector<std::string>& names) const;
+    std::string Read(const std::string& name) const;
+
+  private:
+    static constexpr size_t kInvalidOffset = static_cast<size_t>(-1);
+
+    void* mData = nullptr;
+    size_t mSize = 0;
+    size_t mStart = kInvalidOffset;
+};
+
 void load_hisi_nve();
@@ -6,6 +6,27 @@
 
 #pragma once
 
+#include <hisi_property_batch.h>
+
+#include <functional>
 #include <string>
+#include <vector>
+
+typedef struct hisi_stage {
+    const char* name;
+    std::function<void()> run;
+} hisi_stage_t;
+
+// Publishes properties through the regular property service.
+class SystemPropertyBackend : public PropertyBackend {
+  public:
+    bool Set(const std::string& name, const std::string& value) override;
+};
 
 void set_property(const std::string& prop, const std::string& value);
+
+// Runs every stage on its own thread and waits for all of them to
+// finish. Stages must not depend on each other; anything that has
+// to happen in order belongs inside a single stage.
+void run_stages(const std::vector<hisi_stage_t>& stages);
+
@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2024 The LineageOS Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <hisi_connectivity.h>
+
+#include <hisi_fake_root.h>
+#include <hisi_paths.h>
+
+#include <benchmark/benchmark.h>
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+static constexpr const char* kPhoneProp = "/vendor/phone.prop";
+
+static std::string ProductId(int section) {
+    char prid[16];
+    snprintf(prid, sizeof(prid), "0X%08X", 0x003E0000 + section * 0x100);
+    return prid;
+}
+
+// A phone.prop with the given number of sections, each with a header
+// and a handful of properties, like the ones shipped on the devices.
+static std::string MakePhoneProp(int sections) {
+    std::string contents;
+
+    for (int i = 0; i < sections; i++) {
+        contents += "[" + ProductId(i) + "]\n";
+        contents += "ro.config.hw_opta=" + std::to_string(i) + "\n";
+        contents += "ro.config.hw_optb=156\n";
+        contents += "ro.telephony.default_network=9,9\n";
+        contents += "persist.radio.multisim.config=dsds\n";
+        contents += "ro.config.client_number=" + std::to_string(i % 5) + "\n";
+        contents += "\n";
+    }
+
+    return contents;
+}
+
+// What SetPhoneProperties() used to do, minus publishing the properties.
+static int LegacyFindSection(const std::string& prid, const std::string& path) {
+    int ret = -1;
+    int properties = 0;
+    std::string line;
+    std::ifstream file(path);
+
+    while (std::getline(file, line)) {
+        if (ret == 0 && line.length() == 0) break;
+        if (line.find(prid) != std::string::npos) ret = 0;
+        if (ret == 0 && line.find('=') != std::string::npos) properties++;
+    }
+
+    return ret == 0 ? properties : ret;
+}
+
+// Looks up the section of the last product, the worst case for a scan.
+static void BM_LegacyScan(benchmark::State& state) {
+    FakeRoot root;
+    root.WriteFile(kPhoneProp, MakePhoneProp(state.range(0)));
+    std::string path = hisi_path(kPhoneProp);
+    std::string prid = ProductId(state.range(0) - 1);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(LegacyFindSection(prid, path));
+    }
+}
+BENCHMARK(BM_LegacyScan)->Arg(500)->Arg(2000);
+
+static void BM_PhonePropFile(benchmark::State& state) {
+    FakeRoot root;
+    root.WriteFile(kPhoneProp, MakePhoneProp(state.range(0)));
+    std::string path = hisi_path(kPhoneProp);
+    std::string prid = ProductId(state.range(0) - 1);
+
+    for (auto _ : state) {
+        PhonePropFile file(path);
+        benchmark::DoNotOptimize(file.FindSection(prid));
+    }
+}
+BENCHMARK(BM_PhonePropFile)->Arg(500)->Arg(2000);
+
+// Only the lookup, once the file is mapped and indexed.
+static void BM_PhonePropFileLookup(benchmark::State& state) {
+    FakeRoot root;
+    root.WriteFile(kPhoneProp, MakePhoneProp(state.range(0)));
+    PhonePropFile file(hisi_path(kPhoneProp));
+    std::string prid = ProductId(state.range(0) - 1);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(file.FindSection(prid));
+    }
+}
+BENCHMARK(BM_PhonePropFileLookup)->Arg(500)->Arg(2000);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,152 @@
+/*
+ * Copyright (C) 2024 The LineageOS Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <hisi_nve.h>
+
+#include <hisi_fake_root.h>
+#include <hisi_paths.h>
+
+#include <android-base/file.h>
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+
+static constexpr const char* kNvePath = "/dev/block/by-name/nvme";
+
+// Builds an NVE image with the entry table (starting with the SWVERSI
+// anchor entry) at table_offset, surrounded by filler bytes.
+static std::string MakeNveImage(const std::vector<std::pair<std::string, std::string>>& entries,
+                                size_t table_offset = 4096, size_t size = 64 * 1024) {
+    std::string image(size, '\0');
+
+    // Anything but the anchor.
+    uint32_t seed = 1;
+    for (auto& c : image) {
+        seed = seed * 1103515245 + 12345;
+        c = static_cast<char>('a' + (seed >> 16) % 26);
+    }
+
+    size_t offset = table_offset;
+    auto add = [&](const std::string& name, const std::string& data) {
+        nv_item item = {};
+        item.nv_number = offset;
+        strncpy(item.nv_name, name.c_str(), sizeof(item.nv_name));
+        item.valid_size = data.size();
+        memcpy(item.nv_data, data.data(), std::min(data.size(), sizeof(item.nv_data)));
+        image.replace(offset, sizeof(item), reinterpret_cast<const char*>(&item), sizeof(item));
+        offset += sizeof(item);
+    };
+
+    add("SWVERSI", "1.0");
+    for (const auto& [name, data] : entries) add(name, data);
+
+    return image;
+}
+
+// Returns the number of read syscalls this process has made so far.
+static uint64_t ReadSyscalls() {
+    std::string io;
+    if (!android::base::ReadFileToString("/proc/self/io", &io)) return 0;
+
+    size_t pos = io.find("syscr: ");
+    return pos != std::string::npos ? strtoull(io.c_str() + pos + 7, nullptr, 10) : 0;
+}
+
+// Counts the read syscalls made by fn, minus those it takes to sample
+// /proc/self/io itself.
+template <typename F>
+static uint64_t CountReadSyscalls(F fn) {
+    uint64_t start = ReadSyscalls();
+    uint64_t overhead = ReadSyscalls() - start;
+
+    start = ReadSyscalls();
+    fn();
+    return ReadSyscalls() - start - overhead;
+}
+
+TEST(NveImageTest, ReadsEntries) {
+    FakeRoot root;
+    ASSERT_TRUE(root.WriteFile(kNvePath, MakeNveImage({{"MACWLAN", "001122334455"},
+                                                       {"MACBT", "66778899aabb"}})));
+
+    NveImage image(hisi_path(kNvePath));
+    ASSERT_TRUE(image.IsValid());
+    EXPECT_EQ("001122334455", image.Read("MACWLAN"));
+    EXPECT_EQ("66778899aabb", image.Read("MACBT"));
+    EXPECT_EQ("", image.Read("SERIAL"));
+}
+
+TEST(NveImageTest, BatchReadKeepsFirstEntry) {
+    FakeRoot root;
+    ASSERT_TRUE(root.WriteFile(kNvePath, MakeNveImage({{"MACWLAN", "001122334455"},
+                                                       {"MACBT", "66778899aabb"},
+                                                       {"MACWLAN", "ffffffffffff"}})));
+
+    NveImage image(hisi_path(kNvePath));
+    auto entries = image.Read(std::vector<std::string>{"MACWLAN", "MACBT", "SERIAL"});
+
+    EXPECT_EQ(2u, entries.size());
+    EXPECT_EQ("001122334455", entries["MACWLAN"]);
+    EXPECT_EQ("66778899aabb", entries["MACBT"]);
+    EXPECT_EQ(0u, entries.count("SERIAL"));
+}
+
+TEST(NveImageTest, InvalidWithoutAnchor) {
+    FakeRoot root;
+    ASSERT_TRUE(root.WriteFile(kNvePath, std::string(8192, 'x')));
+
+    NveImage image(hisi_path(kNvePath));
+    EXPECT_FALSE(image.IsValid());
+    EXPECT_EQ("", image.Read("MACWLAN"));
+}
+
+TEST(NveImageTest, InvalidWhenMissingOrEmpty) {
+    FakeRoot root;
+    EXPECT_FALSE(NveImage(hisi_path(kNvePath)).IsValid());
+
+    ASSERT_TRUE(root.WriteFile(kNvePath, ""));
+    EXPECT_FALSE(NveImage(hisi_path(kNvePath)).IsValid());
+}
+
+TEST(NveImageTest, LoadWritesMacFiles) {
+    FakeRoot root;
+    ASSERT_TRUE(root.WriteFile(kNvePath, MakeNveImage({{"MACWLAN", "001122334455"},
+                                                       {"MACBT", "66778899aabb"}})));
+    // The directories exist on the device by the time hisi_init runs.
+    ASSERT_TRUE(root.WriteFile("/data/vendor/wifi/macwlan", ""));
+    ASSERT_TRUE(root.WriteFile("/data/vendor/bluedroid/macbt", ""));
+    ASSERT_TRUE(root.WriteFile("/data/vendor/hisi_init/.keep", ""));
+
+    load_hisi_nve();
+
+    EXPECT_EQ("00:11:22:33:44:55\n", root.ReadFile("/data/vendor/wifi/macwlan"));
+    EXPECT_EQ("66:77:88:99:aa:bb\n", root.ReadFile("/data/vendor/bluedroid/macbt"));
+}
+
+TEST(NveImageTest, BatchReadDoesNoReadSyscalls) {
+    if (access("/proc/self/io", R_OK) != 0) GTEST_SKIP() << "/proc/self/io is unavailable";
+
+    std::vector<std::pair<std::string, std::string>> entries;
+    std::vector<std::string> names;
+    for (int i = 0; i < 64; i++) {
+        entries.emplace_back("ENTRY" + std::to_string(i), std::to_string(i));
+        names.push_back("ENTRY" + std::to_string(i));
+    }
+
+    FakeRoot root;
+    ASSERT_TRUE(root.WriteFile(kNvePath, MakeNveImage(entries, 2 << 20, 4 << 20)));
+
+    // The image is mapped, so neither opening it nor looking up any
+    // number of names should go through read().
+    uint64_t syscalls = CountReadSyscalls([&] {
+        NveImage image(hisi_path(kNvePath));
+        ASSERT_TRUE(image.IsValid());
+        EXPECT_EQ("0", image.Read("ENTRY0"));
+        EXPECT_EQ(names.size(), image.Read(names).size());
+    });
+    EXPECT_EQ(0u, syscalls);
+}
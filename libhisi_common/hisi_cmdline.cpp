@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2024 The LineageOS Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#define LOG_TAG "hisi_cmdline"
+
+#include <hisi_cmdline.h>
+#include <hisi_paths.h>
+
+#include <android-base/file.h>
+#include <android-base/logging.h>
+
+static size_t hash_key(std::string_view key) {
+    uint32_t hash = 2166136261u;
+    for (char c : key) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+bool KernelCmdline::ReadFrom(const std::string& path) {
+    std::string cmdline;
+    if (!android::base::ReadFileToString(path, &cmdline)) {
+        LOG(ERROR) << "Unable to read " << path;
+        return false;
+    }
+
+    Parse(std::move(cmdline));
+    return true;
+}
+
+void KernelCmdline::Parse(std::string cmdline) {
+    mCmdline = std::move(cmdline);
+    mSlots.fill(0);
+    mCount = 0;
+
+    std::string_view rest(mCmdline);
+    while (!rest.empty()) {
+        // Skip the whitespace between arguments.
+        size_t start = rest.find_first_not_of(" \t\n");
+        if (start == std::string_view::npos) break;
+        rest.remove_prefix(start);
+
+        // Spaces inside double quotes don't end an argument.
+        size_t end = 0;
+        bool quoted = false;
+        for (; end < rest.size(); ++end) {
+            if (rest[end] == '"') quoted = !quoted;
+            if (!quoted && (rest[end] == ' ' || rest[end] == '\t' || rest[end] == '\n')) break;
+        }
+
+        std::string_view arg = rest.substr(0, end);
+        rest.remove_prefix(end);
+
+        std::string_view key = arg, value;
+        if (size_t separator = arg.find('='); separator != std::string_view::npos) {
+            key = arg.substr(0, separator);
+            value = arg.substr(separator + 1);
+
+            if (value.size() >= 2 && value.front() == '"' && value.back() == '"') {
+                value = value.substr(1, value.size() - 2);
+            }
+        }
+
+        Insert(key, value);
+    }
+}
+
+void KernelCmdline::Insert(std::string_view key, std::string_view value) {
+    size_t slot = hash_key(key) & (kSlots - 1);
+
+    for (; mSlots[slot] != 0; slot = (slot + 1) & (kSlots - 1)) {
+        Arg& arg = mArgs[mSlots[slot] - 1];
+        if (arg.key == key) {
+            // Later arguments override earlier ones.
+            arg.value = value;
+            return;
+        }
+    }
+
+    if (mCount == kMaxArgs) {
+        LOG(WARNING) << "Ignoring kernel argument " << key << ", too many arguments";
+        return;
+    }
+
+    mArgs[mCount] = {key, value};
+    mSlots[slot] = static_cast<uint16_t>(++mCount);
+}
+
+std::optional<std::string_view> KernelCmdline::Get(std::string_view key) const {
+    size_t slot = hash_key(key) & (kSlots - 1);
+
+    for (; mSlots[slot] != 0; slot = (slot + 1) & (kSlots - 1)) {
+        const Arg& arg = mArgs[mSlots[slot] - 1];
+        if (arg.key == key) return arg.value;
+    }
+
+    return std::nullopt;
+}
+
+const KernelCmdline& kernel_cmdline() {
+    static const KernelCmdline* cmdline = [] {
+        auto parsed = new KernelCmdline();
+        parsed->ReadFrom(hisi_path(kProcCmdline));
+        return parsed;
+    }();
+
+    return *cmdline;
+}
@@ -0,0 +1,18 @@
+/*
+ * Copyright (C) 2024 The LineageOS Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <hisi_paths.h>
+
+#include <stdlib.h>
+
+std::string hisi_path(const std::string& path) {
+#ifdef __ANDROID__
+    return path;
+#else
+    const char* root = getenv("HISI_FAKE_ROOT");
+    return root != nullptr ? root + path : path;
+#endif
+}
@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2024 The LineageOS Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#define LOG_TAG "hisi_property_batch"
+
+#include <hisi_property_batch.h>
+
+#include <android-base/logging.h>
+
+void PropertyBatch::Set(const std::string& name, const std::string& value) {
+    auto [it, inserted] = mIndex.emplace(name, mPending.size());
+
+    if (inserted) {
+        mPending.push_back({name, nullptr, nullptr, 0, value});
+    } else {
+        // Last write wins, but keep the original position.
+        mPending[it->second].value = value;
+    }
+}
+
+void PropertyBatch::SetGroup(void* group, const char* const* names, size_t count,
+                             const std::string& value) {
+    auto [it, inserted] = mGroupIndex.emplace(group, mPending.size());
+
+    if (inserted) {
+        mPending.push_back({"", group, names, count, value});
+    } else {
+        mPending[it->second].value = value;
+    }
+}
+
+size_t PropertyBatch::Commit() {
+    size_t failed = 0;
+
+    for (const auto& entry : mPending) {
+        bool result = entry.group != nullptr
+                              ? mBackend->SetGroup(entry.group, entry.names, entry.count, entry.value)
+                              : mBackend->Set(entry.name, entry.value);
+        if (!result) {
+            LOG(ERROR) << mName << ": unable to set "
+                       << (entry.group != nullptr ? entry.names[0] : entry.name) << " to "
+                       << entry.value;
+            ++failed;
+        }
+    }
+
+    LOG(INFO) << mName << ": committed " << mPending.size() - failed << " of " << mPending.size()
+              << " properties";
+
+    mPending.clear();
+    mIndex.clear();
+    mGroupIndex.clear();
+
+    return failed;
+}
+
+std::vector<std::pair<std::string, std::string>> PropertyBatch::Pending() const {
+    std::vector<std::pair<std::string, std::string>> pending;
+
+    for (const auto& entry : mPending) {
+        if (entry.group == nullptr) {
+            pending.emplace_back(entry.name, entry.value);
+            continue;
+        }
+
+        for (size_t i = 0; i < entry.count; ++i) pending.emplace_back(entry.names[i], entry.value);
+    }
+
+    return pending;
+}
@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2024 The LineageOS Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <hisi_search.h>
+
+#include <cstring>
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+static inline bool matches_at(const uint8_t* at, const uint8_t* needle, size_t needle_size) {
+    // The first and last bytes were already compared by the caller.
+    return needle_size <= 2 || std::memcmp(at + 1, needle + 1, needle_size - 2) == 0;
+}
+
+static size_t find_pattern_scalar(const uint8_t* haystack, size_t size, size_t from,
+                                  const uint8_t* needle, size_t needle_size) {
+    const uint8_t last = needle[needle_size - 1];
+
+    while (from + needle_size <= size) {
+        // Let memchr() skip ahead to the next possible start.
+        auto at = static_cast<const uint8_t*>(
+                std::memchr(haystack + from, needle[0], size - needle_size + 1 - from));
+        if (at == nullptr) break;
+
+        if (at[needle_size - 1] == last && matches_at(at, needle, needle_size)) {
+            return at - haystack;
+        }
+
+        from = at - haystack + 1;
+    }
+
+    return kPatternNotFound;
+}
+
+size_t find_pattern(const void* haystack, size_t size, const void* needle, size_t needle_size) {
+    auto h = static_cast<const uint8_t*>(haystack);
+    auto n = static_cast<const uint8_t*>(needle);
+    size_t i = 0;
+
+    if (needle_size == 0) return 0;
+    if (needle_size > size) return kPatternNotFound;
+
+#if defined(__ARM_NEON)
+    const uint8x16_t first = vdupq_n_u8(n[0]);
+    const uint8x16_t last = vdupq_n_u8(n[needle_size - 1]);
+
+    for (; i + needle_size - 1 + 16 <= size; i += 16) {
+        uint8x16_t eq = vandq_u8(vceqq_u8(first, vld1q_u8(h + i)),
+                                 vceqq_u8(last, vld1q_u8(h + i + needle_size - 1)));
+
+        // Narrow the byte mask to 4 bits per lane so it fits a scalar.
+        uint64_t mask = vget_lane_u64(
+                vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(eq), 4)), 0);
+        while (mask != 0) {
+            size_t bit = __builtin_ctzll(mask) >> 2;
+            if (matches_at(h + i + bit, n, needle_size)) return i + bit;
+            mask &= ~(0xFull << (bit << 2));
+        }
+    }
+#elif defined(__SSE2__)
+    const __m128i first = _mm_set1_epi8(static_cast<char>(n[0]));
+    const __m128i last = _mm_set1_epi8(static_cast<char>(n[needle_size - 1]));
+
+    for (; i + needle_size - 1 + 16 <= size; i += 16) {
+        __m128i block_first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(h + i));
+        __m128i block_last =
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(h + i + needle_size - 1));
+
+        uint32_t mask = _mm_movemask_epi8(
+                _mm_and_si128(_mm_cmpeq_epi8(first, block_first), _mm_cmpeq_epi8(last, block_last)));
+        while (mask != 0) {
+            size_t bit = __builtin_ctz(mask);
+            if (matches_at(h + i + bit, n, needle_size)) return i + bit;
+            mask &= mask - 1;
+        }
+    }
+#endif
+
+    // Whatever is left over (or everything, without SIMD support).
+    return find_pattern_scalar(h, size, i, n, needle_size);
+}
@@ -0,0 +1,120 @@
+/*
+ * Copyright (C) 2024 The LineageOS Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#define LOG_TAG "hisi_sysfs"
+
+#include <hisi_sysfs.h>
+
+#include <android-base/logging.h>
+
+#include <ctype.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <charconv>
+
+// Sysfs attributes are at most a page long.
+static constexpr size_t kMaxNodeSize = 4096;
+
+SysfsNode::SysfsNode(std::string path) : mPath(std::move(path)) {
+    Open();
+}
+
+bool SysfsNode::Open() {
+    if (mFd.ok()) return true;
+
+    // Fall back to read only access, so nodes the HAL may only look at
+    // can still be read.
+    mFd.reset(TEMP_FAILURE_RETRY(open(mPath.c_str(), O_RDWR | O_CLOEXEC)));
+    mWritable = mFd.ok();
+    if (!mFd.ok()) mFd.reset(TEMP_FAILURE_RETRY(open(mPath.c_str(), O_RDONLY | O_CLOEXEC)));
+
+    return mFd.ok();
+}
+
+bool SysfsNode::IsValid() {
+    return Open();
+}
+
+bool SysfsNode::Read(std::string* value) {
+    if (!Open()) return false;
+
+    char buffer[kMaxNodeSize];
+    ssize_t size = TEMP_FAILURE_RETRY(pread(mFd.get(), buffer, sizeof(buffer), 0));
+    if (size < 0) {
+        PLOG(ERROR) << "Unable to read " << mPath;
+        return false;
+    }
+
+    std::string_view contents(buffer, size);
+    while (!contents.empty() && isspace(static_cast<unsigned char>(contents.back()))) {
+        contents.remove_suffix(1);
+    }
+
+    value->assign(contents);
+    mShadow = *value;
+    return true;
+}
+
+bool SysfsNode::ReadInt(int64_t* value) {
+    std::string contents;
+    if (!Read(&contents)) return false;
+
+    const char* end = contents.data() + contents.size();
+    auto [ptr, ec] = std::from_chars(contents.data(), end, *value);
+    if (ec != std::errc() || ptr != end) {
+        LOG(ERROR) << "Invalid integer in " << mPath << ": " << contents;
+        return false;
+    }
+
+    return true;
+}
+
+bool SysfsNode::ReadHex(uint64_t* value) {
+    std::string contents;
+    if (!Read(&contents)) return false;
+
+    std::string_view digits(contents);
+    if (digits.size() > 2 && digits[0] == '0' && (digits[1] == 'x' || digits[1] == 'X')) {
+        digits.remove_prefix(2);
+    }
+
+    const char* end = digits.data() + digits.size();
+    auto [ptr, ec] = std::from_chars(digits.data(), end, *value, 16);
+    if (ec != std::errc() || ptr != end) {
+        LOG(ERROR) << "Invalid hex value in " << mPath << ": " << contents;
+        return false;
+    }
+
+    return true;
+}
+
+bool SysfsNode::Write(std::string_view value) {
+    if (mShadow && *mShadow == value) return true;
+
+    if (!Open() || !mWritable) {
+        LOG(ERROR) << "Unable to open " << mPath << " for writing";
+        return false;
+    }
+
+    ssize_t size = TEMP_FAILURE_RETRY(pwrite(mFd.get(), value.data(), value.size(), 0));
+    if (size != static_cast<ssize_t>(value.size())) {
+        PLOG(ERROR) << "Unable to write " << mPath;
+        // The node may or may not have taken the value.
+        mShadow.reset();
+        return false;
+    }
+
+    mShadow = std::string(value);
+    return true;
+}
+
+bool SysfsNode::WriteInt(int64_t value) {
+    char buffer[24];
+    auto [ptr, ec] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    return Write(std::string_view(buffer, ptr - buffer));
+}
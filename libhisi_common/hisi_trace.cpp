@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2024 The LineageOS Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#define LOG_TAG "hisi_trace"
+
+#include <hisi_trace.h>
+
+#include <android-base/file.h>
+#include <android-base/logging.h>
+
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <mutex>
+#include <vector>
+
+typedef struct {
+    const char* name;
+    int64_t start_us;
+    int64_t duration_us;
+} stage_record_t;
+
+static std::mutex sRecordsMutex;
+static std::vector<stage_record_t> sRecords;
+
+static int trace_marker_fd() {
+    static int fd = []() {
+        int fd = open("/sys/kernel/tracing/trace_marker", O_WRONLY | O_CLOEXEC);
+        if (fd == -1) fd = open("/sys/kernel/debug/tracing/trace_marker", O_WRONLY | O_CLOEXEC);
+        return fd;
+    }();
+    return fd;
+}
+
+// Uses the same "B|pid|name" / "E|pid" format as ATrace, so the
+// slices are picked up by systrace and Perfetto without libcutils.
+static void trace_marker(const std::string& marker) {
+    if (int fd = trace_marker_fd(); fd != -1) {
+        TEMP_FAILURE_RETRY(write(fd, marker.data(), marker.size()));
+    }
+}
+
+static int64_t to_us(std::chrono::steady_clock::duration duration) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+}
+
+ScopedStageTrace::ScopedStageTrace(const char* name)
+    : mName(name), mStart(std::chrono::steady_clock::now()) {
+    trace_marker("B|" + std::to_string(getpid()) + "|" + mName);
+}
+
+ScopedStageTrace::~ScopedStageTrace() {
+    auto end = std::chrono::steady_clock::now();
+    trace_marker("E|" + std::to_string(getpid()));
+
+    std::lock_guard<std::mutex> lock(sRecordsMutex);
+    sRecords.push_back({mName, to_us(mStart.time_since_epoch()), to_us(end - mStart)});
+}
+
+std::string trace_summary() {
+    std::string summary;
+
+    std::lock_guard<std::mutex> lock(sRecordsMutex);
+    for (const auto& record : sRecords) {
+        if (strchr(record.name, '.') != nullptr) continue;
+
+        std::string entry = std::string(record.name) + ':' + std::to_string(record.duration_us);
+        if (summary.size() + !summary.empty() + entry.size() > kTraceSummaryMaxSize) continue;
+
+        if (!summary.empty()) summary += ',';
+        summary += entry;
+    }
+
+    return summary;
+}
+
+void trace_reset() {
+    std::lock_guard<std::mutex> lock(sRecordsMutex);
+    sRecords.clear();
+}
+
+bool trace_write_json(const std::string& path) {
+    std::string json = "[\n";
+
+    {
+        std::lock_guard<std::mutex> lock(sRecordsMutex);
+        for (size_t i = 0; i < sRecords.size(); ++i) {
+            json += "  {\"name\": \"" + std::string(sRecords[i].name) +
+                    "\", \"start_us\": " + std::to_string(sRecords[i].start_us) +
+                    ", \"duration_us\": " + std::to_string(sRecords[i].duration_us) + "}";
+            json += i + 1 < sRecords.size() ? ",\n" : "\n";
+        }
+    }
+
+    json += "]\n";
+
+    if (!android::base::WriteStringToFile(json, path)) {
+        LOG(ERROR) << "Unable to write " << path;
+        return false;
+    }
+
+    return true;
+}
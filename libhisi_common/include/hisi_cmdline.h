@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) 2024 The LineageOS Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+constexpr const char* kProcCmdline = "/proc/cmdline";
+
+// A parsed view of the kernel command line. The command line is split
+// once into key/value views over a single owned buffer and hashed into
+// a fixed size table, so lookups are O(1) and no argument allocates.
+class KernelCmdline {
+  public:
+    static constexpr size_t kMaxArgs = 256;
+
+    KernelCmdline() = default;
+
+    KernelCmdline(const KernelCmdline&) = delete;
+    KernelCmdline& operator=(const KernelCmdline&) = delete;
+
+    bool ReadFrom(const std::string& path = kProcCmdline);
+    void Parse(std::string cmdline);
+
+    // Returns the value of the last occurrence of key, an empty view
+    // for keys without a value, or std::nullopt if key is not present.
+    std::optional<std::string_view> Get(std::string_view key) const;
+
+    // Calls fn(key, value) for every argument whose key starts with
+    // prefix (i.e. "androidboot."), in command line order.
+    template <typename F>
+    void ForEach(std::string_view prefix, F fn) const {
+        for (size_t i = 0; i < mCount; ++i) {
+            if (mArgs[i].key.substr(0, prefix.size()) == prefix) fn(mArgs[i].key, mArgs[i].value);
+        }
+    }
+
+    size_t size() const { return mCount; }
+
+  private:
+    static constexpr size_t kSlots = kMaxArgs * 2;
+
+    typedef struct {
+        std::string_view key;
+        std::string_view value;
+    } Arg;
+
+    void Insert(std::string_view key, std::string_view value);
+
+    std::string mCmdline;
+    std::array<Arg, kMaxArgs> mArgs;
+    // Index into mArgs plus one, zero marks an empty slot.
+    std::array<uint16_t, kSlots> mSlots = {};
+    size_t mCount = 0;
+};
+
+// The kernel command line of this boot, read from hisi_path(kProcCmdline)
+// and parsed the first time it is needed. It is empty if it couldn't be
+// read.
+const KernelCmdline& kernel_cmdline();
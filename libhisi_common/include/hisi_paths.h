@@ -0,0 +1,14 @@
+/*
+ * Copyright (C) 2024 The LineageOS Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <string>
+
+// Resolves an absolute device path (sysfs, procfs, block devices and so
+// on). On the device this is the path itself. Host builds prefix it with
+// $HISI_FAKE_ROOT when set, so every node can be served from a fake tree.
+std::string hisi_path(const std::string& path);
@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2024 The LineageOS Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Where a PropertyBatch ends up writing its properties to.
+class PropertyBackend {
+  public:
+    virtual ~PropertyBackend() = default;
+    virtual bool Set(const std::string& name, const std::string& value) = 0;
+
+    // Sets every name of a property that is known under several names
+    // (i.e. all the partition specific names of a ro.* property). group
+    // identifies the property to backends that can set it faster than
+    // name by name, the others just fall back to Set().
+    virtual bool SetGroup(void* group, const char* const* names, size_t count,
+                          const std::string& value) {
+        (void)group;
+        bool result = true;
+        for (size_t i = 0; i < count; ++i) result &= Set(names[i], value);
+        return result;
+    }
+};
+
+// Keeps properties in memory, i.e. to plan changes without applying them.
+class MemoryPropertyBackend : public PropertyBackend {
+  public:
+    bool Set(const std::string& name, const std::string& value) override {
+        mProperties[name] = value;
+        return true;
+    }
+
+    const std::unordered_map<std::string, std::string>& Properties() const { return mProperties; }
+
+  private:
+    std::unordered_map<std::string, std::string> mProperties;
+};
+
+// Collects property writes and applies them in one go. Setting the
+// same property twice only keeps the last value, and properties are
+// committed in the order they were first set.
+class PropertyBatch {
+  public:
+    PropertyBatch(PropertyBackend* backend, const std::string& name)
+        : mBackend(backend), mName(name) {}
+
+    PropertyBatch(const PropertyBatch&) = delete;
+    PropertyBatch& operator=(const PropertyBatch&) = delete;
+
+    void Set(const std::string& name, const std::string& value);
+
+    // Sets every name of group at once, see PropertyBackend::SetGroup().
+    // Only the group and its value are kept, names has to outlive the
+    // batch.
+    void SetGroup(void* group, const char* const* names, size_t count, const std::string& value);
+
+    // Writes all pending properties to the backend and logs a single
+    // summary line. Returns the number of properties that failed.
+    size_t Commit();
+
+    // Every pending property, with the groups expanded to their names.
+    std::vector<std::pair<std::string, std::string>> Pending() const;
+
+  private:
+    typedef struct {
+        std::string name;
+        void* group;
+        const char* const* names;
+        size_t count;
+        std::string value;
+    } Entry;
+
+    PropertyBackend* mBackend;
+    std::string mName;
+    std::vector<Entry> mPending;
+    std::unordered_map<std::string, size_t> mIndex;
+    std::unordered_map<void*, size_t> mGroupIndex;
+};
@@ -0,0 +1,18 @@
+/*
+ * Copyright (C) 2024 The LineageOS Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+constexpr size_t kPatternNotFound = SIZE_MAX;
+
+// Returns the offset of the first occurrence of needle inside haystack,
+// or kPatternNotFound if there is none. Candidate positions are filtered
+// on the first and last byte of the needle, 16 bytes at a time with
+// NEON or SSE2, before falling back to a full compare.
+size_t find_pattern(const void* haystack, size_t size, const void* needle, size_t needle_size);
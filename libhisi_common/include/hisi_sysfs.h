@@ -0,0 +1,52 @@
+/*
+ * Copyright (C) 2024 The LineageOS Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <android-base/unique_fd.h>
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+// A sysfs attribute that is kept open for the lifetime of the object.
+// Every read or write is a single pread/pwrite at offset 0. The last
+// value read or written is shadowed, so writing it again is free.
+//
+// The node is (re)opened lazily if it wasn't there yet. It is not thread
+// safe, callers serialize access themselves.
+class SysfsNode {
+  public:
+    explicit SysfsNode(std::string path);
+
+    SysfsNode(const SysfsNode&) = delete;
+    SysfsNode& operator=(const SysfsNode&) = delete;
+
+    const std::string& path() const { return mPath; }
+    bool IsValid();
+
+    // Reads the current contents with the trailing whitespace removed.
+    bool Read(std::string* value);
+    bool ReadInt(int64_t* value);
+    // Accepts the value with or without a "0x" prefix.
+    bool ReadHex(uint64_t* value);
+
+    // Skips the write if value is what was last read or written.
+    bool Write(std::string_view value);
+    bool WriteInt(int64_t value);
+
+    // Forgets the shadow value, i.e. after the kernel reset the node.
+    void Invalidate() { mShadow.reset(); }
+
+  private:
+    bool Open();
+
+    std::string mPath;
+    android::base::unique_fd mFd;
+    bool mWritable = false;
+    std::optional<std::string> mShadow;
+};
@@ -0,0 +1,42 @@
+/*
+ * Copyright (C) 2024 The LineageOS Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <chrono>
+#include <string>
+
+// Times a boot stage for as long as it is in scope. The stage shows up
+// as an ATrace compatible slice in the kernel trace buffer (and thus in
+// Perfetto), and its duration is recorded for trace_summary().
+class ScopedStageTrace {
+  public:
+    explicit ScopedStageTrace(const char* name);
+    ~ScopedStageTrace();
+
+    ScopedStageTrace(const ScopedStageTrace&) = delete;
+    ScopedStageTrace& operator=(const ScopedStageTrace&) = delete;
+
+  private:
+    const char* mName;
+    std::chrono::steady_clock::time_point mStart;
+};
+
+// The longest value a non read-only property can hold (PROP_VALUE_MAX - 1).
+constexpr size_t kTraceSummaryMaxSize = 91;
+
+// Returns the top-level stages recorded so far (those without a '.'
+// in their name) in a compact "name:us,..." form, suitable for a
+// property value. Stages that would push it past kTraceSummaryMaxSize
+// are left out, trace_write_json() has the full breakdown.
+std::string trace_summary();
+
+// Forgets every stage recorded so far, i.e. between runs of a host tool.
+void trace_reset();
+
+// Writes every stage recorded so far to path as a JSON array, so runs
+// can be compared automatically on the host.
+bool trace_write_json(const std::string& path);
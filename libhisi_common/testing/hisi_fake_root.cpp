@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2024 The LineageOS Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <hisi_fake_root.h>
+
+#include <android-base/file.h>
+
+#include <ftw.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <string>
+
+static constexpr const char* kFakeRootEnv = "HISI_FAKE_ROOT";
+
+FakeRoot::FakeRoot() {
+    const char* tmp = getenv("TMPDIR");
+    std::string pattern = std::string(tmp != nullptr ? tmp : "/tmp") + "/hisi_fake_root.XXXXXX";
+
+    if (mkdtemp(pattern.data()) != nullptr) mRoot = pattern;
+    setenv(kFakeRootEnv, mRoot.c_str(), 1);
+}
+
+FakeRoot::~FakeRoot() {
+    unsetenv(kFakeRootEnv);
+    if (mRoot.empty()) return;
+
+    // Depth first, so directories are already empty when removed.
+    nftw(
+            mRoot.c_str(),
+            [](const char* path, const struct stat*, int, struct FTW*) { return remove(path); },
+            16, FTW_DEPTH | FTW_PHYS);
+}
+
+bool FakeRoot::WriteFile(const std::string& path, const std::string& contents) const {
+    std::string full = Path(path);
+
+    for (size_t slash = full.find('/', mRoot.size() + 1); slash != std::string::npos;
+         slash = full.find('/', slash + 1)) {
+        mkdir(full.substr(0, slash).c_str(), 0755);
+    }
+
+    return android::base::WriteStringToFile(contents, full);
+}
+
+std::string FakeRoot::ReadFile(const std::string& path) const {
+    std::string contents;
+    android::base::ReadFileToString(Path(path), &contents);
+    return contents;
+}
+
+// Whether fd is a regular file inside the current fake root.
+static bool IsFakeNode(int fd) {
+    const char* root = getenv(kFakeRootEnv);
+    struct stat st;
+    if (root == nullptr || *root == '\0' || fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+        return false;
+    }
+
+    std::string path;
+    if (!android::base::Readlink("/proc/self/fd/" + std::to_string(fd), &path)) return false;
+    return path.compare(0, strlen(root), root) == 0 && path[strlen(root)] == '/';
+}
+
+// Writing a sysfs node replaces its whole value, while the regular files
+// standing in for nodes would keep stale bytes past the end of a shorter
+// value. SysfsNode writes with pwrite() at offset 0, so every test binary
+// linking this helper gets a pwrite() that cuts fake nodes off there.
+static ssize_t FakeNodePwrite(int fd, const void* buf, size_t count, off64_t offset) {
+    ssize_t size = syscall(SYS_pwrite64, fd, buf, count, offset);
+    if (size >= 0 && offset == 0 && IsFakeNode(fd)) ftruncate(fd, size);
+    return size;
+}
+
+extern "C" ssize_t pwrite(int fd, const void* buf, size_t count, off_t offset) {
+    return FakeNodePwrite(fd, buf, count, offset);
+}
+
+extern "C" ssize_t pwrite64(int fd, const void* buf, size_t count, off64_t offset) {
+    return FakeNodePwrite(fd, buf, count, offset);
+}
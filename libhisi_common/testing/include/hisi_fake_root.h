@@ -0,0 +1,33 @@
+/*
+ * Copyright (C) 2024 The LineageOS Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <string>
+
+// A temporary directory that hisi_path() resolves every device path
+// into for as long as the object lives, so daemons and HALs can be run
+// against fake sysfs, procfs and partition files. Host builds only.
+class FakeRoot {
+  public:
+    FakeRoot();
+    ~FakeRoot();
+
+    FakeRoot(const FakeRoot&) = delete;
+    FakeRoot& operator=(const FakeRoot&) = delete;
+
+    const std::string& root() const { return mRoot; }
+
+    // Where the device path ends up inside the fake root.
+    std::string Path(const std::string& path) const { return mRoot + path; }
+
+    // Creates the file, along with any missing parent directories.
+    bool WriteFile(const std::string& path, const std::string& contents) const;
+    std::string ReadFile(const std::string& path) const;
+
+  private:
+    std::string mRoot;
+};
@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2024 The LineageOS Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <hisi_cmdline.h>
+
+#include <android-base/strings.h>
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <vector>
+
+// Roughly what a kirin970 device boots with.
+static constexpr const char* kCmdline =
+        "loglevel=4 initcall_debug=n page_tracker=on unmovable_isolate1=2:192M,3:224M,4:256M "
+        "printktimer=0xfff0a000,0x534,0x538 androidboot.selinux=enforcing buildvariant=user "
+        "androidboot.serialno=ABCDEF0123456789 boardid=0x00006451 productid=0x3e4e00 "
+        "androidboot.hardware=kirin970 androidboot.verifiedbootstate=orange "
+        "androidboot.veritymode=enforcing androidboot.bootreason=normal_reset "
+        "androidboot.mode=normal normal_reset_type=normal_reset boot_slice=0x0002a3f1 "
+        "reboot_reason=AP_S_COLDBOOT exception_subtype=no androidboot.dtbo_idx=18 "
+        "emcp_mem_size=6 androidboot.ddrsize=6 hardware_version=HL2LLDM "
+        "androidboot.hisi_ddrtest=no androidboot.swtype=normal fb_pipe=1 "
+        "androidboot.fpga=0 swiotlb=1 rootwait ro init=/init "
+        "androidboot.oemlock=locked androidboot.ischarging=0 androidboot.dynamic_partitions=true";
+
+// What ReadProductId() used to do for every argument.
+static void BM_SplitLookup(benchmark::State& state) {
+    std::string cmdline = kCmdline;
+
+    for (auto _ : state) {
+        std::string prid;
+        for (const auto& arg : android::base::Split(cmdline, " ")) {
+            std::vector<std::string> parts = android::base::Split(arg, "=");
+            if (parts.size() == 2 && parts[0] == "productid") prid = parts[1];
+        }
+        benchmark::DoNotOptimize(prid);
+    }
+}
+BENCHMARK(BM_SplitLookup);
+
+static void BM_ParseLookup(benchmark::State& state) {
+    std::string cmdline = kCmdline;
+
+    for (auto _ : state) {
+        KernelCmdline parsed;
+        parsed.Parse(cmdline);
+        benchmark::DoNotOptimize(parsed.Get("productid"));
+    }
+}
+BENCHMARK(BM_ParseLookup);
+
+// Lookups on an already parsed command line, like every consumer after
+// the first one does.
+static void BM_Lookup(benchmark::State& state) {
+    KernelCmdline parsed;
+    parsed.Parse(kCmdline);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(parsed.Get("productid"));
+        benchmark::DoNotOptimize(parsed.Get("androidboot.hardware"));
+    }
+}
+BENCHMARK(BM_Lookup);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,27 @@
+/*
+ * Copyright (C) 2024 The LineageOS Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <hisi_cmdline.h>
+
+#include <cstdlib>
+#include <string>
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    KernelCmdline cmdline;
+    cmdline.Parse(std::string(reinterpret_cast<const char*>(data), size));
+
+    if (cmdline.size() > KernelCmdline::kMaxArgs) abort();
+
+    // Every parsed key must be found again through the hash table.
+    size_t count = 0;
+    cmdline.ForEach("", [&](std::string_view key, std::string_view) {
+        if (!cmdline.Get(key)) abort();
+        count++;
+    });
+    if (count != cmdline.size()) abort();
+
+    return 0;
+}
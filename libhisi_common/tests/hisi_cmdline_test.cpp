@@ -0,0 +1,47 @@
+/*
+ * Copyright (C) 2024 The LineageOS Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <hisi_cmdline.h>
+
+#include <hisi_fake_root.h>
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+TEST(KernelCmdlineTest, ParsesArguments) {
+    KernelCmdline cmdline;
+    cmdline.Parse("ro  productid=0x3e4e00 quoted=\"a b\" empty= key=1 key=2\n");
+
+    EXPECT_EQ(5u, cmdline.size());
+    EXPECT_EQ("", cmdline.Get("ro"));
+    EXPECT_EQ("0x3e4e00", cmdline.Get("productid"));
+    EXPECT_EQ("a b", cmdline.Get("quoted"));
+    EXPECT_EQ("", cmdline.Get("empty"));
+    EXPECT_EQ("2", cmdline.Get("key"));
+    EXPECT_EQ(std::nullopt, cmdline.Get("missing"));
+}
+
+TEST(KernelCmdlineTest, ForEachMatchesPrefix) {
+    KernelCmdline cmdline;
+    cmdline.Parse("androidboot.mode=normal boardid=1 androidboot.hardware=kirin970");
+
+    std::vector<std::string> keys;
+    cmdline.ForEach("androidboot.", [&](std::string_view key, std::string_view) {
+        keys.emplace_back(key);
+    });
+
+    EXPECT_EQ((std::vector<std::string>{"androidboot.mode", "androidboot.hardware"}), keys);
+}
+
+TEST(KernelCmdlineTest, SharedInstanceReadsFakeRoot) {
+    FakeRoot root;
+    ASSERT_TRUE(root.WriteFile(kProcCmdline, "productid=0x3e4e00\n"));
+
+    EXPECT_EQ("0x3e4e00", kernel_cmdline().Get("productid"));
+    EXPECT_EQ(&kernel_cmdline(), &kernel_cmdline());
+}
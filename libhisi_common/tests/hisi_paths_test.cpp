@@ -0,0 +1,25 @@
+/*
+ * Copyright (C) 2024 The LineageOS Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <hisi_fake_root.h>
+#include <hisi_paths.h>
+
+#include <gtest/gtest.h>
+
+#include <stdlib.h>
+
+TEST(HisiPathTest, UnchangedWithoutFakeRoot) {
+    unsetenv("HISI_FAKE_ROOT");
+    EXPECT_EQ("/proc/cmdline", hisi_path("/proc/cmdline"));
+}
+
+TEST(HisiPathTest, RedirectedIntoFakeRoot) {
+    FakeRoot root;
+    ASSERT_TRUE(root.WriteFile("/sys/touchscreen/touch_glove", "1\n"));
+
+    EXPECT_EQ(root.Path("/sys/touchscreen/touch_glove"), hisi_path("/sys/touchscreen/touch_glove"));
+    EXPECT_EQ("1\n", root.ReadFile("/sys/touchscreen/touch_glove"));
+}
@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2024 The LineageOS Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <hisi_property_batch.h>
+
+#include <gtest/gtest.h>
+
+namespace {
+
+class RecordingBackend : public MemoryPropertyBackend {
+  public:
+    bool SetGroup(void* group, const char* const* names, size_t count,
+                  const std::string& value) override {
+        groups.push_back(group);
+        return MemoryPropertyBackend::SetGroup(group, names, count, value);
+    }
+
+    std::vector<void*> groups;
+};
+
+constexpr const char* kModelNames[] = {"ro.product.vendor.model", "ro.product.model"};
+
+}  // namespace
+
+TEST(PropertyBatchTest, LastWriteWinsInFirstSetOrder) {
+    MemoryPropertyBackend backend;
+    PropertyBatch batch(&backend, "test");
+
+    batch.Set("a", "1");
+    batch.Set("b", "2");
+    batch.Set("a", "3");
+
+    EXPECT_EQ((std::vector<std::pair<std::string, std::string>>{{"a", "3"}, {"b", "2"}}),
+              batch.Pending());
+    EXPECT_EQ(0u, batch.Commit());
+    EXPECT_EQ("3", backend.Properties().at("a"));
+    EXPECT_TRUE(batch.Pending().empty());
+}
+
+TEST(PropertyBatchTest, GroupsAreCommittedAsOne) {
+    RecordingBackend backend;
+    PropertyBatch batch(&backend, "test");
+    int group;
+
+    batch.SetGroup(&group, kModelNames, 2, "PRA-LX1");
+    batch.Set("c", "4");
+    batch.SetGroup(&group, kModelNames, 2, "PRA-LX2");
+
+    EXPECT_EQ((std::vector<std::pair<std::string, std::string>>{
+                      {"ro.product.vendor.model", "PRA-LX2"},
+                      {"ro.product.model", "PRA-LX2"},
+                      {"c", "4"}}),
+              batch.Pending());
+
+    EXPECT_EQ(0u, batch.Commit());
+    EXPECT_EQ(std::vector<void*>{&group}, backend.groups);
+    EXPECT_EQ("PRA-LX2", backend.Properties().at("ro.product.model"));
+    EXPECT_EQ("PRA-LX2", backend.Properties().at("ro.product.vendor.model"));
+}
@@ -0,0 +1,65 @@
+/*
+ * Copyright (C) 2024 The LineageOS Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <hisi_search.h>
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <string>
+#include <string_view>
+
+static constexpr std::string_view kAnchor = "SWVERSI";
+
+// An image of the given size with the anchor at the very end, filled with
+// bytes that keep hitting the first byte of the anchor like real NVE and
+// oeminfo data does.
+static std::string MakeImage(size_t size) {
+    std::string image(size, '\0');
+    uint32_t seed = 1;
+    for (auto& c : image) {
+        seed = seed * 1103515245 + 12345;
+        c = "SWVER\0\xff"[(seed >> 16) % 7];
+    }
+    image.replace(size - kAnchor.size(), kAnchor.size(), kAnchor);
+    return image;
+}
+
+// What hisi_nve used to do.
+static void BM_StringViewFind(benchmark::State& state) {
+    std::string image = MakeImage(state.range(0));
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(std::string_view(image).find(kAnchor));
+    }
+    state.SetBytesProcessed(state.iterations() * image.size());
+}
+BENCHMARK(BM_StringViewFind)->Arg(4 << 20)->Arg(32 << 20);
+
+// What libinit_variants used to do.
+static void BM_StdSearch(benchmark::State& state) {
+    std::string image = MakeImage(state.range(0));
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(
+                std::search(image.begin(), image.end(), kAnchor.begin(), kAnchor.end()));
+    }
+    state.SetBytesProcessed(state.iterations() * image.size());
+}
+BENCHMARK(BM_StdSearch)->Arg(4 << 20)->Arg(32 << 20);
+
+static void BM_FindPattern(benchmark::State& state) {
+    std::string image = MakeImage(state.range(0));
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(
+                find_pattern(image.data(), image.size(), kAnchor.data(), kAnchor.size()));
+    }
+    state.SetBytesProcessed(state.iterations() * image.size());
+}
+BENCHMARK(BM_FindPattern)->Arg(4 << 20)->Arg(32 << 20);
+
+BENCHMARK_MAIN();
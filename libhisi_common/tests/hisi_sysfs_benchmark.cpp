@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2024 The LineageOS Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <hisi_fake_root.h>
+#include <hisi_paths.h>
+#include <hisi_sysfs.h>
+
+#include <benchmark/benchmark.h>
+
+#include <fstream>
+
+static constexpr const char* kNode = "/sys/touchscreen/touch_glove";
+
+// What the HALs used to do on every call.
+static void BM_StreamRead(benchmark::State& state) {
+    FakeRoot root;
+    root.WriteFile(kNode, "1\n");
+
+    for (auto _ : state) {
+        std::ifstream file(hisi_path(kNode));
+        int value;
+        file >> value;
+        benchmark::DoNotOptimize(value);
+    }
+}
+BENCHMARK(BM_StreamRead);
+
+static void BM_StreamWrite(benchmark::State& state) {
+    FakeRoot root;
+    root.WriteFile(kNode, "1\n");
+    int value = 0;
+
+    for (auto _ : state) {
+        std::ofstream file(hisi_path(kNode));
+        file << (value ^= 1) << std::flush;
+    }
+}
+BENCHMARK(BM_StreamWrite);
+
+static void BM_SysfsNodeRead(benchmark::State& state) {
+    FakeRoot root;
+    root.WriteFile(kNode, "1\n");
+    SysfsNode node(hisi_path(kNode));
+
+    for (auto _ : state) {
+        int64_t value;
+        node.ReadInt(&value);
+        benchmark::DoNotOptimize(value);
+    }
+}
+BENCHMARK(BM_SysfsNodeRead);
+
+static void BM_SysfsNodeWrite(benchmark::State& state) {
+    FakeRoot root;
+    root.WriteFile(kNode, "1\n");
+    SysfsNode node(hisi_path(kNode));
+    int value = 0;
+
+    for (auto _ : state) {
+        node.WriteInt(value ^= 1);
+    }
+}
+BENCHMARK(BM_SysfsNodeWrite);
+
+// Writing what the node already holds costs no syscall at all.
+static void BM_SysfsNodeRedundantWrite(benchmark::State& state) {
+    FakeRoot root;
+    root.WriteFile(kNode, "1\n");
+    SysfsNode node(hisi_path(kNode));
+
+    for (auto _ : state) {
+        node.WriteInt(1);
+    }
+}
+BENCHMARK(BM_SysfsNodeRedundantWrite);
+
+BENCHMARK_MAIN();
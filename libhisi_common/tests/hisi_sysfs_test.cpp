@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2024 The LineageOS Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <hisi_fake_root.h>
+#include <hisi_paths.h>
+#include <hisi_sysfs.h>
+
+#include <gtest/gtest.h>
+
+#include <sys/stat.h>
+
+static constexpr const char* kNode = "/sys/test/node";
+
+TEST(SysfsNodeTest, ReadsTrimmedValue) {
+    FakeRoot root;
+    ASSERT_TRUE(root.WriteFile(kNode, "hello \n"));
+
+    SysfsNode node(hisi_path(kNode));
+    std::string value;
+    ASSERT_TRUE(node.Read(&value));
+    EXPECT_EQ("hello", value);
+}
+
+TEST(SysfsNodeTest, ParsesIntAndHex) {
+    FakeRoot root;
+    SysfsNode node(hisi_path(kNode));
+    int64_t value;
+    uint64_t mask;
+
+    ASSERT_TRUE(root.WriteFile(kNode, "-42\n"));
+    ASSERT_TRUE(node.ReadInt(&value));
+    EXPECT_EQ(-42, value);
+
+    ASSERT_TRUE(root.WriteFile(kNode, "0x0180\n"));
+    ASSERT_TRUE(node.ReadHex(&mask));
+    EXPECT_EQ(0x180u, mask);
+
+    ASSERT_TRUE(root.WriteFile(kNode, "180\n"));
+    ASSERT_TRUE(node.ReadHex(&mask));
+    EXPECT_EQ(0x180u, mask);
+
+    ASSERT_TRUE(root.WriteFile(kNode, "garbage\n"));
+    EXPECT_FALSE(node.ReadInt(&value));
+}
+
+TEST(SysfsNodeTest, WriteReplacesValue) {
+    FakeRoot root;
+    ASSERT_TRUE(root.WriteFile(kNode, "0x0180\n"));
+
+    SysfsNode node(hisi_path(kNode));
+    ASSERT_TRUE(node.WriteInt(1));
+    EXPECT_EQ("1", root.ReadFile(kNode));
+}
+
+TEST(SysfsNodeTest, SkipsRedundantWrites) {
+    FakeRoot root;
+    ASSERT_TRUE(root.WriteFile(kNode, "0"));
+
+    SysfsNode node(hisi_path(kNode));
+    ASSERT_TRUE(node.WriteInt(1));
+
+    // Changed behind the node's back, the shadow still says 1.
+    ASSERT_TRUE(root.WriteFile(kNode, "5"));
+    ASSERT_TRUE(node.WriteInt(1));
+    EXPECT_EQ("5", root.ReadFile(kNode));
+
+    node.Invalidate();
+    ASSERT_TRUE(node.WriteInt(1));
+    EXPECT_EQ("1", root.ReadFile(kNode));
+}
+
+TEST(SysfsNodeTest, OpensLazily) {
+    FakeRoot root;
+    SysfsNode node(hisi_path(kNode));
+    EXPECT_FALSE(node.IsValid());
+
+    ASSERT_TRUE(root.WriteFile(kNode, "7"));
+    int64_t value;
+    ASSERT_TRUE(node.ReadInt(&value));
+    EXPECT_EQ(7, value);
+}
+
+TEST(SysfsNodeTest, ReadOnlyNodeRejectsWrites) {
+    FakeRoot root;
+    ASSERT_TRUE(root.WriteFile(kNode, "3"));
+    ASSERT_EQ(0, chmod(root.Path(kNode).c_str(), 0444));
+
+    // Root can write anything, so there is nothing to check.
+    if (getuid() == 0) GTEST_SKIP() << "running as root";
+
+    SysfsNode node(hisi_path(kNode));
+    int64_t value;
+    ASSERT_TRUE(node.ReadInt(&value));
+    EXPECT_FALSE(node.WriteInt(4));
+}
+
+TEST(SysfsNodeTest, FakeNodeTakesWholeValue) {
+    FakeRoot root;
+    ASSERT_TRUE(root.WriteFile(kNode, "0x0000\n"));
+
+    // Like sysfs, a shorter value replaces the old one entirely.
+    SysfsNode node(hisi_path(kNode));
+    ASSERT_TRUE(node.Write("12"));
+    EXPECT_EQ("12", root.ReadFile(kNode));
+}
@@ -0,0 +1,30 @@
+/*
+ * Copyright (C) 2024 The LineageOS Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <hisi_trace.h>
+
+#include <android-base/file.h>
+
+#include <gtest/gtest.h>
+
+TEST(HisiTraceTest, SummaryFitsInAProperty) {
+    { ScopedStageTrace trace("stage_with_a_long_name_0"); }
+    { ScopedStageTrace trace("stage.substage"); }
+    for (int i = 0; i < 8; i++) ScopedStageTrace trace("stage_with_a_long_name_n");
+
+    std::string summary = trace_summary();
+    EXPECT_LE(summary.size(), kTraceSummaryMaxSize);
+    EXPECT_EQ(0u, summary.find("stage_with_a_long_name_0:"));
+    EXPECT_EQ(std::string::npos, summary.find("substage"));
+
+    // The JSON output keeps everything.
+    TemporaryFile json;
+    ASSERT_TRUE(trace_write_json(json.path));
+
+    std::string contents;
+    ASSERT_TRUE(android::base::ReadFileToString(json.path, &contents));
+    EXPECT_NE(std::string::npos, contents.find("\"stage.substage\""));
+}
@@ -6,15 +6,69 @@
 
 #pragma once
 
+#include <hisi_property_batch.h>
+
+#include <cstdint>
 #include <string>
+#include <vector>
+
+// Sizes are in KiB, so that both "16m" and "512k" can be expressed.
+typedef struct dalvik_heap_profile {
+    uint32_t ram_mb;
+    uint32_t heapstartsize;
+    uint32_t heapgrowthlimit;
+    uint32_t heapsize;
+    uint32_t heapminfree;
+    uint32_t heapmaxfree;
+    float heaptargetutilization;
+} dalvik_heap_profile_t;
+
+// The other memory and CPU dependent knobs of a RAM tier. Sizes are
+// in KiB.
+typedef struct device_tier_profile {
+    uint32_t ram_mb;
+    uint32_t jitinitialsize;
+    uint32_t jitmaxsize;
+    bool lmk_critical_upgrade;
+    uint32_t lmk_upgrade_pressure;
+    uint32_t lmk_downgrade_pressure;
+    bool lmk_kill_heaviest_task;
+    uint32_t lmk_swap_free_low_percentage;
+} device_tier_profile_t;
+
+typedef struct cpu_topology {
+    uint32_t cores;
+    uint32_t big_cores;
+} cpu_topology_t;
+
+typedef struct memory_info {
+    uint64_t total_mb;
+    // The zram size the fstab configures, swap isn't enabled yet.
+    uint64_t swap_mb;
+} memory_info_t;
+
+bool read_memory_info(memory_info_t* info);
+bool read_cpu_topology(cpu_topology_t* topology);
+
+// Returns the RAM size the device ships with, which is a bit more
+// than what the kernel reports once its reservations are taken out.
+uint64_t nominal_ram_mb(const memory_info_t& info);
+
+// The RAM size both the heap profile and the device tier are picked by,
+// which is the nominal size plus a quarter of the zram size.
+uint64_t tier_ram_mb(const memory_info_t& info);
+
+// Parses an override table, one tier per line:
+//   <ram_mb> <startsize> <growthlimit> <heapsize> <minfree> <maxfree> <targetutilization>
+// with sizes such as "16m" or "512k". Lines starting with '#' are ignored.
+// Rows whose sizes contradict each other, or whose target utilization is
+// outside (0, 1), make the whole table invalid.
+bool parse_dalvik_heap_profiles(const std::string& contents,
+                                std::vector<dalvik_heap_profile_t>* profiles);
 
-typedef struct dalvik_heap_info {
-    std::string heapstartsize;
-    std::string heapgrowthlimit;
-    std::string heapsize;
-    std::string heapminfree;
-    std::string heapmaxfree;
-    std::string heaptargetutilization;
-} dalvik_heap_info_t;
+// Picks the profile for the given amount of memory. Growth limit and
+// target utilization are interpolated between the surrounding tiers.
+dalvik_heap_profile_t resolve_dalvik_heap_profile(const std::vector<dalvik_heap_profile_t>& profiles,
+                                                  const memory_info_t& info);
 
-void load_dalvik();
+void load_dalvik(PropertyBatch* batch);
@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2024 The LineageOS Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Record ids found in the OEM_INFO record headers.
+constexpr uint32_t kOemInfoProductInfo = 0x4E;
+
+#pragma pack(push, 1)
+typedef struct oeminfo_header {
+    char magic[8];  // "OEM_INFO"
+    uint32_t version;
+    uint32_t id;
+    uint32_t type;
+    uint32_t length;
+    uint32_t age;
+} oeminfo_header_t;
+#pragma pack(pop)
+
+// All the records of the oeminfo partition, enumerated in a single
+// bounded scan. Payloads are copied into one buffer owned by the
+// image, and handed out as views into it.
+class OemInfoImage {
+  public:
+    // The scan stops once the record region is over, or as soon as
+    // every record in ids has been found if ids isn't empty.
+    explicit OemInfoImage(const std::string& path, const std::vector<uint32_t>& ids = {});
+
+    OemInfoImage(const OemInfoImage&) = delete;
+    OemInfoImage& operator=(const OemInfoImage&) = delete;
+
+    bool IsValid() const { return !mRecords.empty(); }
+    size_t size() const { return mRecords.size(); }
+
+    // Returns the raw payload of the newest record with the given id
+    // and type, or an empty view if there is none.
+    std::string_view Get(uint32_t id, uint32_t type = 1) const;
+
+    // Same as Get(), but skips the 0xFF padding in front of the value
+    // and stops at the first NUL, for records holding a string.
+    std::string_view GetString(uint32_t id, uint32_t type = 1) const;
+
+  private:
+    typedef struct {
+        uint32_t age;
+        size_t offset;
+        size_t length;
+    } RecordInfo;
+
+    std::string mPayloads;
+    std::map<std::pair<uint32_t, uint32_t>, RecordInfo> mRecords;
+};
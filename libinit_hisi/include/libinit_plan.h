@@ -0,0 +1,32 @@
+/*
+ * Copyright (C) 2024 The LineageOS Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <hisi_property_batch.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+typedef struct property_plan {
+    // Every property that would be set, in the order it would be set.
+    std::vector<std::pair<std::string, std::string>> properties;
+    // How long every stage took, in trace_summary() format.
+    std::string timing;
+} property_plan_t;
+
+// Runs every stage of vendor_load_properties() against batch.
+void load_vendor_properties(PropertyBatch* batch);
+
+// Runs every stage of vendor_load_properties() against backend instead
+// of the real property area, and returns what would have been set.
+property_plan_t plan_vendor_properties(PropertyBackend* backend);
+
+// Compares a plan against the contents of a build.prop file. Returns
+// one line per property that would be added ("+ name=value") or changed
+// ("~ name=old -> new"), properties that would stay the same are skipped.
+std::string diff_property_plan(const property_plan_t& plan, const std::string& build_prop);
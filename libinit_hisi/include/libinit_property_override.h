@@ -0,0 +1,37 @@
+/*
+ * Copyright (C) 2024 The LineageOS Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <libinit_utils.h>
+
+#include <string>
+
+// These write to the property area directly, which only works from
+// within init, while it is still loading the build properties.
+
+bool property_override(const std::string& prop, const std::string& value, bool add = true);
+
+// Overrides every name of prop without allocating. Returns false if
+// any of them could not be set.
+bool ro_prop_override(ro_prop_t* prop, const std::string& value);
+
+void set_ro_build_prop(const std::string& prop, const std::string& value, bool product = false);
+
+// Publishes properties directly through property_override(), which
+// also works for read-only properties while init is still loading them.
+class PropertyOverrideBackend : public PropertyBackend {
+  public:
+    bool Set(const std::string& name, const std::string& value) override {
+        return property_override(name, value);
+    }
+
+    // Groups only ever come from set_ro_build_prop(), which queues a
+    // ro_prop_t with its cached handles.
+    bool SetGroup(void* group, const char* const*, size_t, const std::string& value) override {
+        return ro_prop_override(static_cast<ro_prop_t*>(group), value);
+    }
+};
@@ -6,9 +6,51 @@
 
 #pragma once
 
+#include <hisi_property_batch.h>
+
+#include <cstddef>
 #include <string>
 #include <vector>
 
-void property_override(std::string prop, std::string value, bool add = true);
+struct prop_info;
+
+constexpr size_t kRoPropSources = 9;
+
+// Expand to every partition specific name of a ro.product.<prop> or a
+// ro.build.<prop> property at compile time, in the same order as
+// ro_props_default_source_order.
+#define RO_PRODUCT_PROP(prop)                                                              \
+    {                                                                                      \
+        "ro.product.odm." prop, "ro.product.odm_dlkm." prop, "ro.product.product." prop,   \
+                "ro.product.system." prop, "ro.product.system_dlkm." prop,                 \
+                "ro.product.system_ext." prop, "ro.product.vendor." prop,                  \
+                "ro.product.vendor_dlkm." prop, "ro.product." prop                         \
+    }
+
+#define RO_BUILD_PROP(prop)                                                                   \
+    {                                                                                         \
+        "ro.odm.build." prop, "ro.odm_dlkm.build." prop, "ro.product.build." prop,            \
+                "ro.system.build." prop, "ro.system_dlkm.build." prop,                        \
+                "ro.system_ext.build." prop, "ro.vendor.build." prop,                         \
+                "ro.vendor_dlkm.build." prop, "ro.build." prop                                \
+    }
+
+// A ro.* property together with all of its partition specific names.
+// The prop_info handles are looked up on first use and then reused.
+typedef struct ro_prop {
+    const char* prop;
+    bool product;
+    const char* names[kRoPropSources];
+    prop_info* handles[kRoPropSources];
+} ro_prop_t;
+
+extern ro_prop_t ro_product_brand;
+extern ro_prop_t ro_product_device;
+extern ro_prop_t ro_product_model;
+extern ro_prop_t ro_product_name;
+extern ro_prop_t ro_build_fingerprint;
 
-void set_ro_build_prop(const std::string& prop, const std::string& value, bool product = false);
+void set_ro_build_prop(PropertyBatch* batch, const std::string& prop, const std::string& value,
+                       bool product = false);
+// Queues prop as a whole, so it is committed through ro_prop_override().
+void set_ro_build_prop(PropertyBatch* batch, ro_prop_t* prop, const std::string& value);
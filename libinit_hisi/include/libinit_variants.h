@@ -6,4 +6,6 @@
 
 #pragma once
 
-void load_variants();
+#include <hisi_property_batch.h>
+
+void load_variants(PropertyBatch* batch);
@@ -6,10 +6,25 @@
 
 #include "vendor_init.h"
 
-#include <libinit_dalvik.h>
-#include <libinit_variants.h>
+#include <libinit_plan.h>
+#include <libinit_property_override.h>
+
+#include <hisi_trace.h>
+
+constexpr const char* kPropBootTiming = "ro.vendor.hisi.init_timing";
 
 void vendor_load_properties() {
-    load_dalvik();
-    load_variants();
+    PropertyOverrideBackend backend;
+
+    {
+        PropertyBatch batch(&backend, "vendor_load_properties");
+        load_vendor_properties(&batch);
+
+        ScopedStageTrace trace("property_commit");
+        batch.Commit();
+    }
+
+    // Publish how long every stage took, so boot regressions show up
+    // without having to capture a trace.
+    property_override(kPropBootTiming, trace_summary());
 }
@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2024 The LineageOS Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#define LOG_TAG "init_hisi_plan"
+
+#include <libinit_plan.h>
+
+#include <hisi_trace.h>
+
+#include <android-base/file.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <iostream>
+#include <vector>
+
+static void PrintPlan(const property_plan_t& plan, const std::string& build_prop, bool diff) {
+    if (diff) {
+        std::cout << diff_property_plan(plan, build_prop);
+    } else {
+        for (const auto& [name, value] : plan.properties) {
+            std::cout << name << "=" << value << std::endl;
+        }
+    }
+
+    std::cout << "# timing: " << plan.timing << std::endl;
+}
+
+// Prints the properties vendor_load_properties() would set on this
+// device without setting any of them, optionally as a diff against
+// a build.prop snapshot.
+//
+// On the host, every --root names a directory laid out like the device
+// (i.e. <root>/dev/block/by-name/oeminfo, <root>/proc/meminfo) holding
+// one device's images, and the plan is printed for each of them.
+//
+//   init_hisi_plan [--root <dir>]... [build.prop]
+int main(int argc, char** argv) {
+    std::vector<std::string> roots;
+    std::string build_prop;
+    bool diff = false;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--root") == 0 && i + 1 < argc) {
+            roots.push_back(argv[++i]);
+        } else if (!android::base::ReadFileToString(argv[i], &build_prop)) {
+            std::cerr << "Unable to read " << argv[i] << std::endl;
+            return 1;
+        } else {
+            diff = true;
+        }
+    }
+
+#ifdef __ANDROID__
+    if (!roots.empty()) {
+        std::cerr << "--root is only supported on the host" << std::endl;
+        return 1;
+    }
+#endif
+
+    if (roots.empty()) {
+        MemoryPropertyBackend backend;
+        PrintPlan(plan_vendor_properties(&backend), build_prop, diff);
+        return 0;
+    }
+
+    for (const auto& root : roots) {
+        setenv("HISI_FAKE_ROOT", root.c_str(), 1);
+        trace_reset();
+
+        MemoryPropertyBackend backend;
+        std::cout << "# root: " << root << std::endl;
+        PrintPlan(plan_vendor_properties(&backend), build_prop, diff);
+    }
+
+    return 0;
+}
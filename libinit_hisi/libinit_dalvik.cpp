@@ -9,9 +9,22 @@
 #include <libinit_dalvik.h>
 #include <libinit_utils.h>
 
+#include <hisi_paths.h>
+#include <hisi_trace.h>
+
+#include <android-base/file.h>
 #include <android-base/logging.h>
+#include <android-base/parseint.h>
+#include <android-base/properties.h>
+#include <android-base/strings.h>
+
+#include <unistd.h>
 
-#include <sys/sysinfo.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <sstream>
 
 #define HEAPSTARTSIZE_PROP "dalvik.vm.heapstartsize"
 #define HEAPGROWTHLIMIT_PROP "dalvik.vm.heapgrowthlimit"
@@ -20,56 +33,327 @@
 #define HEAPMAXFREE_PROP "dalvik.vm.heapmaxfree"
 #define HEAPTARGETUTILIZATION_PROP "dalvik.vm.heaptargetutilization"
 
-#define GB(b) (b * 1024ull * 1024 * 1024)
+#define DEX2OAT_THREADS_PROP "dalvik.vm.dex2oat-threads"
+#define IMAGE_DEX2OAT_THREADS_PROP "dalvik.vm.image-dex2oat-threads"
+#define JITINITIALSIZE_PROP "dalvik.vm.jitinitialsize"
+#define JITMAXSIZE_PROP "dalvik.vm.jitmaxsize"
 
-static const dalvik_heap_info_t dalvik_heap_info_6144 = {
-        .heapstartsize = "16m",
-        .heapgrowthlimit = "256m",
-        .heapsize = "512m",
-        .heapminfree = "8m",
-        .heapmaxfree = "32m",
-        .heaptargetutilization = "0.5",
-};
+#define LMK_CRITICAL_UPGRADE_PROP "ro.lmk.critical_upgrade"
+#define LMK_UPGRADE_PRESSURE_PROP "ro.lmk.upgrade_pressure"
+#define LMK_DOWNGRADE_PRESSURE_PROP "ro.lmk.downgrade_pressure"
+#define LMK_KILL_HEAVIEST_TASK_PROP "ro.lmk.kill_heaviest_task"
+#define LMK_SWAP_FREE_LOW_PERCENTAGE_PROP "ro.lmk.swap_free_low_percentage"
+
+#define MB(m) ((m) * 1024u)
+
+constexpr const char* kMemInfoPath = "/proc/meminfo";
+constexpr const char* kFstabPrefix = "/vendor/etc/fstab.";
+constexpr const char* kZramSizeFlag = "zramsize=";
+constexpr const char* kHeapProfilesPath = "/vendor/etc/dalvik_heap_profiles.conf";
+constexpr const char* kCpuPath = "/sys/devices/system/cpu";
+
+// The suffixes fs_mgr tries when looking for the default fstab.
+constexpr const char* kFstabSuffixProps[] = {"ro.boot.fstab_suffix", "ro.hardware",
+                                             "ro.hardware.platform"};
 
-static const dalvik_heap_info_t dalvik_heap_info_4096 = {
-        .heapstartsize = "8m",
-        .heapgrowthlimit = "256m",
-        .heapsize = "512m",
-        .heapminfree = "8m",
-        .heapmaxfree = "16m",
-        .heaptargetutilization = "0.6",
+// Usual RAM sizes, used to turn the reported memory (which excludes
+// whatever the kernel reserved) back into the size the device ships with.
+constexpr uint32_t kNominalRamSizes[] = {1024, 1536, 2048, 3072, 4096, 6144, 8192, 12288, 16384};
+
+// clang-format off
+static const std::vector<dalvik_heap_profile_t> kDefaultHeapProfiles = {
+    // ram_mb  start    growth    heap      minfree  maxfree  target
+    {2048,     MB(8),   MB(192),  MB(512),  512,     MB(8),   0.75f},
+    {3072,     MB(8),   MB(256),  MB(512),  512,     MB(8),   0.75f},
+    {4096,     MB(8),   MB(256),  MB(512),  MB(8),   MB(16),  0.6f},
+    {6144,     MB(16),  MB(256),  MB(512),  MB(8),   MB(32),  0.5f},
+    {8192,     MB(24),  MB(384),  MB(512),  MB(8),   MB(48),  0.46f},
+    {12288,    MB(24),  MB(384),  MB(512),  MB(8),   MB(56),  0.42f},
 };
 
-static const dalvik_heap_info_t dalvik_heap_info_2048 = {
-        .heapstartsize = "8m",
-        .heapgrowthlimit = "192m",
-        .heapsize = "512m",
-        .heapminfree = "512k",
-        .heapmaxfree = "8m",
-        .heaptargetutilization = "0.75",
+static const std::vector<device_tier_profile_t> kDeviceTierProfiles = {
+    // ram_mb  jitinit  jitmax   crit   up   down heaviest swap
+    {2048,     64,      MB(32),  true,  40,  60,  false,   10},
+    {3072,     128,     MB(64),  true,  60,  80,  false,   10},
+    {4096,     128,     MB(64),  false, 100, 100, true,    20},
+    {6144,     256,     MB(128), false, 100, 100, true,    20},
 };
+// clang-format on
+
+// Returns the zram size the fstab asks for, either in bytes or as a
+// percentage of the memory (i.e. "zramsize=50%"), or 0 if there is none.
+static uint64_t read_zram_size_mb(uint64_t total_mb) {
+    std::string contents;
+
+    for (const char* prop : kFstabSuffixProps) {
+        std::string suffix = android::base::GetProperty(prop, "");
+        if (!suffix.empty() &&
+            android::base::ReadFileToString(hisi_path(kFstabPrefix + suffix), &contents)) {
+            break;
+        }
+        contents.clear();
+    }
+
+    for (const auto& line : android::base::Split(contents, "\n")) {
+        std::istringstream iss(line);
+        std::string src, mount_point, type, mnt_flags, fs_mgr_flags;
+        if (!(iss >> src >> mount_point >> type >> mnt_flags >> fs_mgr_flags) || src[0] == '#') {
+            continue;
+        }
+
+        for (const auto& flag : android::base::Split(fs_mgr_flags, ",")) {
+            if (!android::base::StartsWith(flag, kZramSizeFlag)) continue;
+
+            std::string value = flag.substr(strlen(kZramSizeFlag));
+            uint64_t size;
+            if (!value.empty() && value.back() == '%') {
+                value.pop_back();
+                if (android::base::ParseUint(value, &size, uint64_t{100})) {
+                    return total_mb * size / 100;
+                }
+            } else if (android::base::ParseUint(value, &size)) {
+                return size / (1024 * 1024);
+            }
+
+            LOG(ERROR) << "Invalid zram size: " << flag;
+            return 0;
+        }
+    }
+
+    return 0;
+}
+
+bool read_memory_info(memory_info_t* info) {
+    std::string meminfo;
+    uint64_t total_kb = 0;
+
+    if (!android::base::ReadFileToString(hisi_path(kMemInfoPath), &meminfo)) {
+        LOG(ERROR) << "Unable to read " << kMemInfoPath;
+        return false;
+    }
+
+    std::istringstream iss(meminfo);
+    std::string key;
+    uint64_t value;
+    while (iss >> key >> value) {
+        if (key == "MemTotal:") total_kb = value;
+        iss.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    }
+
+    // Neither swap nor the zram device are set up this early during
+    // boot, so go by what the fstab is going to configure.
+    info->total_mb = total_kb / 1024;
+    info->swap_mb = read_zram_size_mb(info->total_mb);
+    return total_kb != 0;
+}
+
+bool read_cpu_topology(cpu_topology_t* topology) {
+    long cores = sysconf(_SC_NPROCESSORS_CONF);
+    if (cores <= 0) return false;
+
+    // The big cores are the ones that can clock the highest.
+    std::vector<uint64_t> max_freqs;
+    for (long cpu = 0; cpu < cores; ++cpu) {
+        std::string freq;
+        uint64_t khz;
+        std::string path = std::string(kCpuPath) + "/cpu" + std::to_string(cpu) +
+                           "/cpufreq/cpuinfo_max_freq";
+        if (android::base::ReadFileToString(hisi_path(path), &freq) &&
+            android::base::ParseUint(android::base::Trim(freq), &khz)) {
+            max_freqs.push_back(khz);
+        }
+    }
+
+    topology->cores = static_cast<uint32_t>(cores);
+    topology->big_cores = topology->cores;
+
+    if (!max_freqs.empty()) {
+        uint64_t fastest = *std::max_element(max_freqs.begin(), max_freqs.end());
+        topology->big_cores = std::count(max_freqs.begin(), max_freqs.end(), fastest);
+    }
+
+    return true;
+}
+
+uint64_t nominal_ram_mb(const memory_info_t& info) {
+    for (uint32_t nominal : kNominalRamSizes) {
+        if (nominal >= info.total_mb) return nominal;
+    }
+
+    return info.total_mb;
+}
+
+uint64_t tier_ram_mb(const memory_info_t& info) {
+    // Compressed swap gives apps some headroom, but nowhere near as
+    // much as real memory does, so only count a quarter of it.
+    return nominal_ram_mb(info) + info.swap_mb / 4;
+}
+
+static bool parse_size(const std::string& str, uint32_t* kb) {
+    if (str.empty()) return false;
+
+    uint32_t scale = 1;
+    std::string digits = str;
+    if (digits.back() == 'm' || digits.back() == 'M') {
+        scale = 1024;
+        digits.pop_back();
+    } else if (digits.back() == 'k' || digits.back() == 'K') {
+        digits.pop_back();
+    }
 
-void load_dalvik() {
-    struct sysinfo sys;
-    const dalvik_heap_info_t* dhi;
-
-    sysinfo(&sys);
-
-    if (sys.totalram > GB(5)) {
-        LOG(INFO) << "Setting dalvik props for >6gb devices";
-        dhi = &dalvik_heap_info_6144;
-    } else if (sys.totalram > GB(3)) {
-        LOG(INFO) << "Setting dalvik props for >4gb devices";
-        dhi = &dalvik_heap_info_4096;
-    } else {
-        LOG(INFO) << "Setting dalvik props for <3gb devices";
-        dhi = &dalvik_heap_info_2048;
+    uint32_t value;
+    if (!android::base::ParseUint(digits, &value, std::numeric_limits<uint32_t>::max() / scale)) {
+        return false;
     }
 
-    property_override(HEAPSTARTSIZE_PROP, dhi->heapstartsize);
-    property_override(HEAPGROWTHLIMIT_PROP, dhi->heapgrowthlimit);
-    property_override(HEAPSIZE_PROP, dhi->heapsize);
-    property_override(HEAPTARGETUTILIZATION_PROP, dhi->heaptargetutilization);
-    property_override(HEAPMINFREE_PROP, dhi->heapminfree);
-    property_override(HEAPMAXFREE_PROP, dhi->heapmaxfree);
+    *kb = value * scale;
+    return true;
+}
+
+static std::string format_size(uint32_t kb) {
+    return kb % 1024 == 0 ? std::to_string(kb / 1024) + "m" : std::to_string(kb) + "k";
+}
+
+static std::string format_ratio(float value) {
+    std::string str = std::to_string(std::round(value * 100) / 100);
+
+    // Drop the trailing zeros, i.e. "0.750000" -> "0.75".
+    str.erase(str.find_last_not_of('0') + 1);
+    if (str.back() == '.') str.pop_back();
+
+    return str;
+}
+
+bool parse_dalvik_heap_profiles(const std::string& contents,
+                                std::vector<dalvik_heap_profile_t>* profiles) {
+    std::vector<dalvik_heap_profile_t> result;
+
+    for (const auto& line : android::base::Split(contents, "\n")) {
+        std::string trimmed = android::base::Trim(line);
+        if (trimmed.empty() || trimmed[0] == '#') continue;
+
+        std::istringstream iss(trimmed);
+        std::string start, growth, heap, minfree, maxfree;
+        dalvik_heap_profile_t profile;
+
+        if (!(iss >> profile.ram_mb >> start >> growth >> heap >> minfree >> maxfree >>
+              profile.heaptargetutilization) ||
+            !parse_size(start, &profile.heapstartsize) ||
+            !parse_size(growth, &profile.heapgrowthlimit) || !parse_size(heap, &profile.heapsize) ||
+            !parse_size(minfree, &profile.heapminfree) ||
+            !parse_size(maxfree, &profile.heapmaxfree)) {
+            LOG(ERROR) << "Invalid dalvik heap profile: " << trimmed;
+            return false;
+        }
+
+        if (profile.ram_mb == 0 || profile.heapstartsize > profile.heapsize ||
+            profile.heapgrowthlimit > profile.heapsize ||
+            profile.heapminfree > profile.heapmaxfree || !(profile.heaptargetutilization > 0) ||
+            !(profile.heaptargetutilization < 1)) {
+            LOG(ERROR) << "Inconsistent dalvik heap profile: " << trimmed;
+            return false;
+        }
+
+        result.push_back(profile);
+    }
+
+    if (result.empty()) return false;
+
+    std::sort(result.begin(), result.end(),
+              [](const auto& a, const auto& b) { return a.ram_mb < b.ram_mb; });
+
+    *profiles = std::move(result);
+    return true;
+}
+
+dalvik_heap_profile_t resolve_dalvik_heap_profile(const std::vector<dalvik_heap_profile_t>& profiles,
+                                                  const memory_info_t& info) {
+    uint64_t ram_mb = tier_ram_mb(info);
+
+    auto upper = std::find_if(profiles.begin(), profiles.end(),
+                              [ram_mb](const auto& profile) { return profile.ram_mb > ram_mb; });
+    if (upper == profiles.begin()) return profiles.front();
+    if (upper == profiles.end()) return profiles.back();
+
+    // Take everything from the tier we are in, and move the growth
+    // limit and target utilization towards the next tier.
+    auto lower = upper - 1;
+    float t = static_cast<float>(ram_mb - lower->ram_mb) / (upper->ram_mb - lower->ram_mb);
+
+    dalvik_heap_profile_t profile = *lower;
+    profile.ram_mb = ram_mb;
+    profile.heapgrowthlimit =
+            MB(static_cast<uint32_t>(std::lround(
+                    (lower->heapgrowthlimit + t * (static_cast<float>(upper->heapgrowthlimit) -
+                                                   lower->heapgrowthlimit)) /
+                    1024)));
+    profile.heapgrowthlimit = std::min(profile.heapgrowthlimit, profile.heapsize);
+    profile.heaptargetutilization =
+            lower->heaptargetutilization +
+            t * (upper->heaptargetutilization - lower->heaptargetutilization);
+
+    return profile;
+}
+
+static void load_device_tier(PropertyBatch* batch, const memory_info_t& info) {
+    uint64_t ram_mb = tier_ram_mb(info);
+    cpu_topology_t topology;
+
+    // Use the highest tier the device has enough memory for.
+    auto tier = kDeviceTierProfiles.begin();
+    for (auto it = kDeviceTierProfiles.begin(); it != kDeviceTierProfiles.end(); ++it) {
+        if (it->ram_mb <= ram_mb) tier = it;
+    }
+
+    LOG(INFO) << "Setting device tier props for " << tier->ram_mb << "mb";
+
+    batch->Set(JITINITIALSIZE_PROP, format_size(tier->jitinitialsize));
+    batch->Set(JITMAXSIZE_PROP, format_size(tier->jitmaxsize));
+
+    batch->Set(LMK_CRITICAL_UPGRADE_PROP, tier->lmk_critical_upgrade ? "true" : "false");
+    batch->Set(LMK_UPGRADE_PRESSURE_PROP, std::to_string(tier->lmk_upgrade_pressure));
+    batch->Set(LMK_DOWNGRADE_PRESSURE_PROP, std::to_string(tier->lmk_downgrade_pressure));
+    batch->Set(LMK_KILL_HEAVIEST_TASK_PROP, tier->lmk_kill_heaviest_task ? "true" : "false");
+    batch->Set(LMK_SWAP_FREE_LOW_PERCENTAGE_PROP,
+               std::to_string(tier->lmk_swap_free_low_percentage));
+
+    // Regular compilation should stay on the big cores, while the boot
+    // image is compiled before anything else runs and can use them all.
+    if (read_cpu_topology(&topology)) {
+        LOG(INFO) << "Found " << topology.cores << " cores, " << topology.big_cores << " big";
+        batch->Set(DEX2OAT_THREADS_PROP, std::to_string(topology.big_cores));
+        batch->Set(IMAGE_DEX2OAT_THREADS_PROP, std::to_string(topology.cores));
+    }
+}
+
+void load_dalvik(PropertyBatch* batch) {
+    ScopedStageTrace trace("load_dalvik");
+    std::vector<dalvik_heap_profile_t> profiles = kDefaultHeapProfiles;
+    memory_info_t info = {};
+    std::string contents;
+
+    if (!read_memory_info(&info)) {
+        LOG(ERROR) << "Unable to determine the amount of memory, not setting dalvik props";
+        return;
+    }
+
+    // Devices can ship their own tiers, which replace the default ones.
+    if (android::base::ReadFileToString(hisi_path(kHeapProfilesPath), &contents) &&
+        !parse_dalvik_heap_profiles(contents, &profiles)) {
+        LOG(ERROR) << "Ignoring invalid " << kHeapProfilesPath;
+        profiles = kDefaultHeapProfiles;
+    }
+
+    dalvik_heap_profile_t profile = resolve_dalvik_heap_profile(profiles, info);
+    LOG(INFO) << "Setting dalvik props for " << profile.ram_mb << "mb (" << info.total_mb
+              << "mb memory, " << info.swap_mb << "mb zram)";
+
+    batch->Set(HEAPSTARTSIZE_PROP, format_size(profile.heapstartsize));
+    batch->Set(HEAPGROWTHLIMIT_PROP, format_size(profile.heapgrowthlimit));
+    batch->Set(HEAPSIZE_PROP, format_size(profile.heapsize));
+    batch->Set(HEAPTARGETUTILIZATION_PROP, format_ratio(profile.heaptargetutilization));
+    batch->Set(HEAPMINFREE_PROP, format_size(profile.heapminfree));
+    batch->Set(HEAPMAXFREE_PROP, format_size(profile.heapmaxfree));
+
+    load_device_tier(batch, info);
 }
@@ -0,0 +1,148 @@
+/*
+ * Copyright (C) 2024 The LineageOS Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#define LOG_TAG "libinit_oeminfo"
+
+#include <libinit_oeminfo.h>
+
+#include <hisi_search.h>
+#include <hisi_trace.h>
+
+#include <android-base/logging.h>
+#include <android-base/unique_fd.h>
+
+#include <cstring>
+#include <set>
+#include <vector>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+
+constexpr const char kOemInfoMagic[] = {'O', 'E', 'M', '_', 'I', 'N', 'F', 'O'};
+constexpr size_t kOemInfoWindowSize = 64 * 1024;
+
+// Anything larger than this is a stray match, not a real header.
+constexpr uint32_t kOemInfoMaxRecordSize = 64 * 1024;
+
+// The records are packed at the start of the partition, the rest of it
+// (tens of MiB) is padding. Once this much has gone by without another
+// header, the record region is over.
+constexpr off_t kOemInfoMaxRecordGap = 1024 * 1024;
+
+// Reads up to size bytes at offset, retrying on short reads. Returns
+// the number of bytes actually read, which is less than size at EOF.
+static size_t ReadAt(int fd, void* buffer, size_t size, off_t offset) {
+    size_t total = 0;
+
+    while (total < size) {
+        ssize_t n = TEMP_FAILURE_RETRY(
+                pread(fd, static_cast<char*>(buffer) + total, size - total, offset + total));
+        if (n <= 0) break;
+        total += n;
+    }
+
+    return total;
+}
+
+OemInfoImage::OemInfoImage(const std::string& path, const std::vector<uint32_t>& ids) {
+    ScopedStageTrace trace("oeminfo.scan");
+
+    android::base::unique_fd fd(open(path.c_str(), O_RDONLY | O_CLOEXEC));
+    if (fd == -1) {
+        LOG(ERROR) << "Unable to open: " << path << ", error: " << strerror(errno);
+        return;
+    }
+
+    // We only ever read forward, let the kernel read ahead for us.
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+    // Scan the partition in fixed size windows. Consecutive windows
+    // overlap by one byte less than a header, so a header that
+    // straddles two windows is still seen in full.
+    std::vector<char> window(kOemInfoWindowSize);
+    std::vector<std::pair<off_t, oeminfo_header_t>> headers;
+    std::set<uint32_t> missing(ids.begin(), ids.end());
+    off_t window_offset = 0;
+    off_t last_header = 0;
+    off_t scanned = 0;
+
+    while (true) {
+        size_t length = ReadAt(fd, window.data(), window.size(), window_offset);
+        scanned = window_offset + length;
+        if (length < sizeof(oeminfo_header_t)) break;
+
+        size_t limit = length - sizeof(oeminfo_header_t) + 1;
+        for (size_t offset = 0; offset < limit;) {
+            size_t found = find_pattern(window.data() + offset, length - offset, kOemInfoMagic,
+                                        sizeof(kOemInfoMagic));
+            if (found == kPatternNotFound || offset + found >= limit) break;
+            offset += found;
+
+            oeminfo_header_t header;
+            std::memcpy(&header, window.data() + offset, sizeof(header));
+            if (header.length <= kOemInfoMaxRecordSize) {
+                headers.emplace_back(window_offset + offset, header);
+                missing.erase(header.id);
+                last_header = window_offset + offset;
+            }
+
+            offset += sizeof(header);
+        }
+
+        if (length < window.size()) break;
+
+        // Newer copies of a record sit next to the older ones, so stop
+        // at the end of the window in which every wanted id showed up.
+        if (!ids.empty() && missing.empty()) break;
+        if (!headers.empty() && window_offset + limit - last_header > kOemInfoMaxRecordGap) break;
+
+        window_offset += limit;
+    }
+
+    // Only keep the newest copy of every record.
+    std::map<std::pair<uint32_t, uint32_t>, std::pair<off_t, oeminfo_header_t>> newest;
+    for (const auto& [offset, header] : headers) {
+        auto [it, inserted] = newest.try_emplace({header.id, header.type}, offset, header);
+        if (!inserted && header.age > it->second.second.age) it->second = {offset, header};
+    }
+
+    // Pull every payload into a single buffer, bounded by the length
+    // from its header and by the end of the partition.
+    size_t total = 0;
+    for (const auto& [key, record] : newest) total += record.second.length;
+    mPayloads.resize(total);
+
+    size_t offset = 0;
+    for (const auto& [key, record] : newest) {
+        size_t length = ReadAt(fd, mPayloads.data() + offset, record.second.length,
+                               record.first + sizeof(oeminfo_header_t));
+        mRecords[key] = {record.second.age, offset, length};
+        offset += record.second.length;
+    }
+
+    LOG(INFO) << "Found " << mRecords.size() << " records in the first "
+              << scanned << " bytes of " << path;
+}
+
+std::string_view OemInfoImage::Get(uint32_t id, uint32_t type) const {
+    auto it = mRecords.find({id, type});
+    if (it == mRecords.end()) return {};
+
+    return std::string_view(mPayloads).substr(it->second.offset, it->second.length);
+}
+
+std::string_view OemInfoImage::GetString(uint32_t id, uint32_t type) const {
+    std::string_view value = Get(id, type);
+
+    // Skip over 0xFF bytes
+    size_t start = value.find_first_not_of('\xFF');
+    if (start == std::string_view::npos) return {};
+    value.remove_prefix(start);
+
+    return value.substr(0, value.find('\0'));
+}
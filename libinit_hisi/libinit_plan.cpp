@@ -0,0 +1,64 @@
+/*
+ * Copyright (C) 2024 The LineageOS Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#define LOG_TAG "libinit_plan"
+
+#include <libinit_dalvik.h>
+#include <libinit_plan.h>
+#include <libinit_variants.h>
+
+#include <hisi_trace.h>
+
+#include <android-base/strings.h>
+
+#include <unordered_map>
+
+void load_vendor_properties(PropertyBatch* batch) {
+    ScopedStageTrace trace("vendor_load_properties");
+
+    load_dalvik(batch);
+    load_variants(batch);
+}
+
+property_plan_t plan_vendor_properties(PropertyBackend* backend) {
+    property_plan_t plan;
+    PropertyBatch batch(backend, "plan_vendor_properties");
+
+    load_vendor_properties(&batch);
+
+    plan.properties = batch.Pending();
+    batch.Commit();
+    plan.timing = trace_summary();
+
+    return plan;
+}
+
+std::string diff_property_plan(const property_plan_t& plan, const std::string& build_prop) {
+    std::unordered_map<std::string, std::string> current;
+    std::string diff;
+
+    for (const auto& line : android::base::Split(build_prop, "\n")) {
+        std::string trimmed = android::base::Trim(line);
+        if (trimmed.empty() || trimmed[0] == '#') continue;
+
+        size_t separator = trimmed.find('=');
+        if (separator == std::string::npos) continue;
+
+        // Later definitions override earlier ones, just like in init.
+        current[trimmed.substr(0, separator)] = trimmed.substr(separator + 1);
+    }
+
+    for (const auto& [name, value] : plan.properties) {
+        auto it = current.find(name);
+        if (it == current.end()) {
+            diff += "+ " + name + "=" + value + "\n";
+        } else if (it->second != value) {
+            diff += "~ " + name + "=" + it->second + " -> " + value + "\n";
+        }
+    }
+
+    return diff;
+}
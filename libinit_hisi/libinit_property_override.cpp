@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2024 The LineageOS Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#define _REALLY_INCLUDE_SYS__SYSTEM_PROPERTIES_H_
+#include <sys/_system_properties.h>
+#include <string.h>
+
+#include <libinit_property_override.h>
+
+static ro_prop_t* const kKnownRoProps[] = {
+        &ro_product_brand, &ro_product_device,    &ro_product_model,
+        &ro_product_name,  &ro_build_fingerprint,
+};
+
+static bool property_override(const char* name, prop_info** handle, const std::string& value) {
+    if (*handle == nullptr) *handle = (prop_info*)__system_property_find(name);
+
+    if (*handle != nullptr) {
+        return __system_property_update(*handle, value.c_str(), value.length()) == 0;
+    }
+
+    if (__system_property_add(name, strlen(name), value.c_str(), value.length()) != 0) {
+        return false;
+    }
+
+    // Remember the freshly added property for the next update.
+    *handle = (prop_info*)__system_property_find(name);
+    return true;
+}
+
+bool property_override(const std::string& prop, const std::string& value, bool add) {
+    auto pi = (prop_info*)__system_property_find(prop.c_str());
+    if (pi != nullptr) {
+        return __system_property_update(pi, value.c_str(), value.length()) == 0;
+    } else if (add) {
+        return __system_property_add(prop.c_str(), prop.length(), value.c_str(), value.length()) == 0;
+    }
+    return true;
+}
+
+bool ro_prop_override(ro_prop_t* prop, const std::string& value) {
+    bool result = true;
+
+    for (size_t i = 0; i < kRoPropSources; ++i) {
+        result &= property_override(prop->names[i], &prop->handles[i], value);
+    }
+
+    return result;
+}
+
+void set_ro_build_prop(const std::string& prop, const std::string& value, bool product) {
+    // The common properties have their names and handles ready.
+    for (auto known : kKnownRoProps) {
+        if (known->product == product && prop == known->prop) {
+            ro_prop_override(known, value);
+            return;
+        }
+    }
+
+    PropertyOverrideBackend backend;
+    PropertyBatch batch(&backend, "ro." + prop);
+
+    set_ro_build_prop(&batch, prop, value, product);
+    batch.Commit();
+}
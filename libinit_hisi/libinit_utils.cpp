@@ -4,35 +4,33 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
-#define _REALLY_INCLUDE_SYS__SYSTEM_PROPERTIES_H_
-#include <sys/_system_properties.h>
-#include <vector>
-
 #include <libinit_utils.h>
 
-void property_override(std::string prop, std::string value, bool add) {
-    auto pi = (prop_info*)__system_property_find(prop.c_str());
-    if (pi != nullptr) {
-        __system_property_update(pi, value.c_str(), value.length());
-    } else if (add) {
-        __system_property_add(prop.c_str(), prop.length(), value.c_str(), value.length());
-    }
-}
+ro_prop_t ro_product_brand = {"brand", true, RO_PRODUCT_PROP("brand"), {}};
+ro_prop_t ro_product_device = {"device", true, RO_PRODUCT_PROP("device"), {}};
+ro_prop_t ro_product_model = {"model", true, RO_PRODUCT_PROP("model"), {}};
+ro_prop_t ro_product_name = {"name", true, RO_PRODUCT_PROP("name"), {}};
+ro_prop_t ro_build_fingerprint = {"fingerprint", false, RO_BUILD_PROP("fingerprint"), {}};
 
-std::vector<std::string> ro_props_default_source_order = {
+static constexpr const char* ro_props_default_source_order[kRoPropSources] = {
         "odm.",        "odm_dlkm.", "product.",     "system.", "system_dlkm.",
         "system_ext.", "vendor.",   "vendor_dlkm.", "",
 };
 
-void set_ro_build_prop(const std::string& prop, const std::string& value, bool product) {
+void set_ro_build_prop(PropertyBatch* batch, const std::string& prop, const std::string& value,
+                       bool product) {
     std::string prop_name;
 
     for (const auto& source : ro_props_default_source_order) {
         if (product)
-            prop_name = "ro.product." + source + prop;
+            prop_name = "ro.product." + std::string(source) + prop;
         else
-            prop_name = "ro." + source + "build." + prop;
+            prop_name = "ro." + std::string(source) + "build." + prop;
 
-        property_override(prop_name, value, true);
+        batch->Set(prop_name, value);
     }
 }
+
+void set_ro_build_prop(PropertyBatch* batch, ro_prop_t* prop, const std::string& value) {
+    batch->SetGroup(prop, prop->names, kRoPropSources, value);
+}
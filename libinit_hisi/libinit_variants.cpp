@@ -5,20 +5,18 @@
  */
 
 #define LOG_TAG "libinit_variants"
+#include <libinit_oeminfo.h>
 #include <libinit_utils.h>
 #include <libinit_variants.h>
 
+#include <hisi_paths.h>
+#include <hisi_trace.h>
+
 #include <android-base/logging.h>
 #include <android-base/strings.h>
 
 #include <sstream>
 
-#include <errno.h>
-#include <fcntl.h>
-#include <sys/mman.h>
-#include <sys/stat.h>
-#include <unistd.h>
-
 struct ProductInfo {
     std::string model;
     std::string version;
@@ -26,9 +24,8 @@ struct ProductInfo {
 };
 
 constexpr const char* kOemInfoPath = "/dev/block/by-name/oeminfo";
-std::vector<unsigned char> pattern = {0x4F, 0x45, 0x4D, 0x5F, 0x49, 0x4E, 0x46, 0x4F, 0x06, 0x00,
-                                      0x00, 0x00, 0x4E, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00,
-                                      0x80, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00};
+constexpr const char* kPropRegion = "ro.vendor.oeminfo.region";
+constexpr const char* kPropVersion = "ro.vendor.oeminfo.version";
 
 ProductInfo ParseProductInfo(const std::string& product_info_str) {
     ProductInfo product_info;
@@ -37,76 +34,60 @@ ProductInfo ParseProductInfo(const std::string& product_info_str) {
     // Extract the model (i.e. "PRA-LX1").
     std::getline(iss, product_info.model, ' ');
 
-    // Extract the version (i.e. "9.1.0.311") including parentheses if present.
+    // Extract the version (i.e. "9.1.0.311"), up to the parentheses if present.
     std::getline(iss, product_info.version, '(');
+    bool has_region = !iss.eof();
 
     // Remove trailing whitespace.
-    android::base::Trim(product_info.version);
-
-    // If version is enclosed in parentheses, extract the region_type.
-    if (!product_info.version.empty() && product_info.version.back() == ')') {
-        product_info.version.pop_back();
+    product_info.version = android::base::Trim(product_info.version);
 
+    // If the version is followed by parentheses, extract the region_type.
+    if (has_region) {
         // Extract the region_type (i.e. "C185E3R2P1").
         std::getline(iss, product_info.region_type, ')');
 
         // Trim leading and trailing whitespaces from region_type.
-        android::base::Trim(product_info.region_type);
+        product_info.region_type = android::base::Trim(product_info.region_type);
     }
 
     return product_info;
 }
 
-ProductInfo ReadProductInfo() {
+ProductInfo ReadProductInfo(const OemInfoImage& image) {
     ProductInfo product_info = {};
 
-    int fd = open(kOemInfoPath, O_RDONLY);
-    if (fd == -1) {
-        LOG(ERROR) << "Unable to open: " << kOemInfoPath << ", error: " << strerror(errno);
-        return product_info;
-    }
-
-    off_t size = lseek(fd, 0, SEEK_END);
-    lseek(fd, 0, SEEK_SET);  // Go back.
-
-    void* buffer = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
-    if (buffer == MAP_FAILED) {
-        LOG(ERROR) << "Unable to map: " << kOemInfoPath << ", error: " << strerror(errno);
-        close(fd);
-        return product_info;
-    }
-
-    auto begin = static_cast<unsigned char*>(buffer);
-    auto end = begin + size;
-    auto it = std::search(begin, end, pattern.begin(), pattern.end());
-
-    if (it != end) {
-        // Skip over 0xFF bytes
-        auto name_start = it + pattern.size();
-        while (*name_start == 0xFF && name_start < end) {
-            ++name_start;
-        }
-        // Parse the product info
-        product_info = ParseProductInfo(std::string(reinterpret_cast<char*>(name_start)));
-    } else {
+    std::string_view value = image.GetString(kOemInfoProductInfo);
+    if (value.empty()) {
         LOG(ERROR) << "Unable to find product name in: " << kOemInfoPath;
+        return product_info;
     }
 
-    munmap(buffer, size);
-    close(fd);
+    // Parse the product info
+    product_info = ParseProductInfo(std::string(value));
 
     return product_info;
 }
 
-void load_variants() {
-    ProductInfo product_info = ReadProductInfo();
+void load_variants(PropertyBatch* batch) {
+    ScopedStageTrace trace("load_variants");
+
+    // Every record is read from the partition in a single scan, which
+    // stops as soon as the records we need have been found.
+    OemInfoImage image(hisi_path(kOemInfoPath), {kOemInfoProductInfo});
+    ProductInfo product_info = ReadProductInfo(image);
 
     // Load the phone model dynamically from the oeminfo partition.
-    if (!product_info.model.empty()) {
-        LOG(INFO) << "Found product info: " << product_info.model << " " << product_info.version
-                  << " " << product_info.region_type;
-        set_ro_build_prop("model", product_info.model, true);
-    } else {
+    if (product_info.model.empty()) {
         LOG(ERROR) << "Unable to parse product information!";
+        return;
     }
+
+    LOG(INFO) << "Found product info: " << product_info.model << " " << product_info.version
+              << " " << product_info.region_type;
+    set_ro_build_prop(batch, &ro_product_model, product_info.model);
+
+    // The stock build the device shipped with, i.e. "9.1.0.311" and
+    // "C432E4R1P9". It has nothing to do with the running build.
+    if (!product_info.version.empty()) batch->Set(kPropVersion, product_info.version);
+    if (!product_info.region_type.empty()) batch->Set(kPropRegion, product_info.region_type);
 }
@@ -0,0 +1,64 @@
+/*
+ * Copyright (C) 2024 The LineageOS Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libinit_dalvik.h>
+
+#include <hisi_fake_root.h>
+
+#include <android-base/properties.h>
+#include <gtest/gtest.h>
+
+static constexpr const char* kMemInfo = "MemTotal: 3800000 kB\nSwapTotal: 0 kB\n";
+
+class LibinitDalvikTest : public ::testing::Test {
+  protected:
+    void SetUp() override {
+        ASSERT_TRUE(mRoot.WriteFile("/proc/meminfo", kMemInfo));
+        android::base::SetProperty("ro.hardware", "kirin970");
+    }
+
+    void TearDown() override { android::base::SetProperty("ro.hardware", ""); }
+
+    FakeRoot mRoot;
+};
+
+TEST_F(LibinitDalvikTest, ZramSizeFromFstab) {
+    memory_info_t info;
+
+    ASSERT_TRUE(read_memory_info(&info));
+    EXPECT_EQ(3710u, info.total_mb);
+    EXPECT_EQ(0u, info.swap_mb);
+
+    ASSERT_TRUE(mRoot.WriteFile("/vendor/etc/fstab.kirin970",
+                                "# <src> <mnt_point> <type> <mnt_flags> <fs_mgr_flags>\n"
+                                "/dev/block/zram0 none swap defaults zramsize=2147483648\n"));
+    ASSERT_TRUE(read_memory_info(&info));
+    EXPECT_EQ(2048u, info.swap_mb);
+    EXPECT_EQ(4096u + 512u, tier_ram_mb(info));
+
+    ASSERT_TRUE(mRoot.WriteFile("/vendor/etc/fstab.kirin970",
+                                "/dev/block/zram0 none swap defaults wait,zramsize=50%\n"));
+    ASSERT_TRUE(read_memory_info(&info));
+    EXPECT_EQ(3710u / 2, info.swap_mb);
+}
+
+TEST_F(LibinitDalvikTest, RejectsInconsistentProfiles) {
+    std::vector<dalvik_heap_profile_t> profiles;
+
+    EXPECT_TRUE(parse_dalvik_heap_profiles("4096 8m 256m 512m 8m 16m 0.6\n", &profiles));
+    ASSERT_EQ(1u, profiles.size());
+    EXPECT_EQ(256u * 1024, profiles[0].heapgrowthlimit);
+
+    // Growth limit above the heap size.
+    EXPECT_FALSE(parse_dalvik_heap_profiles("4096 8m 768m 512m 8m 16m 0.6\n", &profiles));
+    // Target utilization outside (0, 1).
+    EXPECT_FALSE(parse_dalvik_heap_profiles("4096 8m 256m 512m 8m 16m 1.5\n", &profiles));
+    EXPECT_FALSE(parse_dalvik_heap_profiles("4096 8m 256m 512m 8m 16m 0\n", &profiles));
+    // Min free above max free.
+    EXPECT_FALSE(parse_dalvik_heap_profiles("4096 8m 256m 512m 32m 16m 0.6\n", &profiles));
+    // 4194304m doesn't fit in 32 bits of KiB.
+    EXPECT_FALSE(parse_dalvik_heap_profiles("4096 8m 256m 4194304m 8m 16m 0.6\n", &profiles));
+}
@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2024 The LineageOS Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <libinit_oeminfo.h>
+#include <libinit_plan.h>
+
+#include <hisi_fake_root.h>
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <map>
+
+static std::string MakeOemInfo(const std::string& product_info) {
+    std::string image(4 << 20, '\xFF');
+
+    oeminfo_header_t header = {};
+    memcpy(header.magic, "OEM_INFO", sizeof(header.magic));
+    header.version = 6;
+    header.id = kOemInfoProductInfo;
+    header.type = 1;
+    header.length = product_info.size() + 1;
+    header.age = 1;
+
+    image.replace(0x2000, sizeof(header), reinterpret_cast<const char*>(&header), sizeof(header));
+    image.replace(0x2000 + sizeof(header), product_info.size() + 1, product_info.c_str(),
+                  product_info.size() + 1);
+    return image;
+}
+
+static std::map<std::string, std::string> Plan() {
+    MemoryPropertyBackend backend;
+    property_plan_t plan = plan_vendor_properties(&backend);
+    return {plan.properties.begin(), plan.properties.end()};
+}
+
+TEST(LibinitPlanTest, PlansFromFakeRoot) {
+    FakeRoot root;
+    ASSERT_TRUE(root.WriteFile("/proc/meminfo", "MemTotal: 5800000 kB\nSwapTotal: 0 kB\n"));
+    ASSERT_TRUE(root.WriteFile("/dev/block/by-name/oeminfo",
+                               MakeOemInfo("PRA-LX1 9.1.0.311(C432E4R1P9)")));
+
+    auto properties = Plan();
+    EXPECT_EQ("PRA-LX1", properties["ro.product.model"]);
+    EXPECT_EQ("PRA-LX1", properties["ro.product.vendor.model"]);
+    EXPECT_EQ("C432E4R1P9", properties["ro.vendor.oeminfo.region"]);
+    EXPECT_EQ("9.1.0.311", properties["ro.vendor.oeminfo.version"]);
+    EXPECT_EQ(0u, properties.count("ro.build.fingerprint"));
+    EXPECT_EQ("512m", properties["dalvik.vm.heapsize"]);
+}
+
+TEST(LibinitPlanTest, SkipsMissingImages) {
+    FakeRoot root;
+
+    auto properties = Plan();
+    EXPECT_EQ(0u, properties.count("ro.product.model"));
+    EXPECT_EQ(0u, properties.count("dalvik.vm.heapsize"));
+}
+
+TEST(LibinitPlanTest, DiffsAgainstBuildProp) {
+    property_plan_t plan;
+    plan.properties = {{"a", "1"}, {"b", "2"}, {"c", "3"}};
+
+    EXPECT_EQ("~ b=1 -> 2\n+ c=3\n", diff_property_plan(plan, "# comment\na=1\nb=0\nb=1\n"));
+}
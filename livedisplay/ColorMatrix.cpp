@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2024 The LineageOS Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "ColorMatrix.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace aidl {
+namespace vendor {
+namespace lineage {
+namespace livedisplay {
+
+// Rec. 709 luma weights.
+static constexpr float kLumaR = 0.2126f;
+static constexpr float kLumaG = 0.7152f;
+static constexpr float kLumaB = 0.0722f;
+
+ColorMatrix ColorMatrix::identity() {
+    return diagonal(kOne, kOne, kOne);
+}
+
+ColorMatrix ColorMatrix::diagonal(int32_t r, int32_t g, int32_t b) {
+    return {{r, 0, 0, 0, g, 0, 0, 0, b}};
+}
+
+ColorMatrix ColorMatrix::fromFloat(const std::array<float, 9>& m) {
+    ColorMatrix result;
+
+    for (size_t i = 0; i < 9; ++i) {
+        result.values[i] = static_cast<int32_t>(std::lround(m[i] * kOne));
+    }
+
+    return result;
+}
+
+ColorMatrix ColorMatrix::hue(float degrees) {
+    const float angle = degrees * static_cast<float>(M_PI) / 180.0f;
+    const float c = std::cos(angle);
+    const float s = std::sin(angle);
+
+    // Keeps the luminance of every color while rotating its hue.
+    return fromFloat({
+            kLumaR + c * (1 - kLumaR) - s * kLumaR,
+            kLumaG - c * kLumaG - s * kLumaG,
+            kLumaB - c * kLumaB + s * (1 - kLumaB),
+            kLumaR - c * kLumaR + s * 0.143f,
+            kLumaG + c * (1 - kLumaG) + s * 0.140f,
+            kLumaB - c * kLumaB - s * 0.283f,
+            kLumaR - c * kLumaR - s * (1 - kLumaR),
+            kLumaG - c * kLumaG + s * kLumaG,
+            kLumaB + c * (1 - kLumaB) + s * kLumaB,
+    });
+}
+
+ColorMatrix ColorMatrix::saturation(float factor) {
+    const float r = (1 - factor) * kLumaR;
+    const float g = (1 - factor) * kLumaG;
+    const float b = (1 - factor) * kLumaB;
+
+    // Blends every color with its gray level.
+    return fromFloat({
+            r + factor, g, b,
+            r, g + factor, b,
+            r, g, b + factor,
+    });
+}
+
+ColorMatrix ColorMatrix::gain(float factor) {
+    const int32_t value = static_cast<int32_t>(std::lround(factor * kOne));
+    return diagonal(value, value, value);
+}
+
+ColorMatrix ColorMatrix::operator*(const ColorMatrix& other) const {
+    ColorMatrix result;
+
+    for (size_t row = 0; row < 3; ++row) {
+        for (size_t col = 0; col < 3; ++col) {
+            int64_t sum = 0;
+            for (size_t k = 0; k < 3; ++k) {
+                sum += static_cast<int64_t>(values[row * 3 + k]) * other.values[k * 3 + col];
+            }
+            // Round to nearest when dropping back to Q15.
+            result.values[row * 3 + col] = static_cast<int32_t>((sum + kOne / 2) >> 15);
+        }
+    }
+
+    return result;
+}
+
+ColorMatrix ColorMatrix::normalized() const {
+    int64_t largest = kOne;
+    for (int32_t value : values) largest = std::max<int64_t>(largest, std::abs(value));
+
+    if (largest == kOne) return *this;
+
+    ColorMatrix result;
+    for (size_t i = 0; i < 9; ++i) {
+        // Round towards zero, so the result stays within range.
+        result.values[i] = static_cast<int32_t>(values[i] * int64_t{kOne} / largest);
+    }
+
+    return result;
+}
+
+std::string ColorMatrix::toString() const {
+    std::string contents;
+
+    for (size_t i = 0; i < 9; ++i) {
+        if (i > 0) contents += ",";
+        contents += std::to_string(std::clamp(values[i], -kOne, kOne));
+    }
+
+    return contents;
+}
+
+}  // namespace livedisplay
+}  // namespace lineage
+}  // namespace vendor
+}  // namespace aidl
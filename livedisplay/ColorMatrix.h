@@ -0,0 +1,55 @@
+/*
+ * Copyright (C) 2024 The LineageOS Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+namespace aidl {
+namespace vendor {
+namespace lineage {
+namespace livedisplay {
+
+// A 3x3 color matrix in Q15 fixed point (32768 is 1.0), stored row
+// major, which is the layout lcd_color_temperature expects. The plain
+// arrays and loops keep the math easy for the compiler to vectorize.
+class ColorMatrix {
+  public:
+    static constexpr int32_t kOne = 32768;
+
+    static ColorMatrix identity();
+    static ColorMatrix diagonal(int32_t r, int32_t g, int32_t b);
+    static ColorMatrix fromFloat(const std::array<float, 9>& m);
+
+    // Building blocks for picture adjustment and display modes. Hue is
+    // a rotation around the gray axis in degrees, saturation and gain
+    // are factors where 1.0 leaves the image untouched.
+    static ColorMatrix hue(float degrees);
+    static ColorMatrix saturation(float factor);
+    static ColorMatrix gain(float factor);
+
+    ColorMatrix operator*(const ColorMatrix& other) const;
+
+    // Scales the whole matrix down so that no coefficient is beyond
+    // what the panel accepts, instead of clamping single coefficients
+    // and skewing the colors.
+    ColorMatrix normalized() const;
+    bool operator==(const ColorMatrix& other) const { return values == other.values; }
+    bool operator!=(const ColorMatrix& other) const { return values != other.values; }
+
+    // Formats the matrix for the sysfs node, clamping every coefficient
+    // to what the panel accepts.
+    std::string toString() const;
+
+    std::array<int32_t, 9> values;
+};
+
+}  // namespace livedisplay
+}  // namespace lineage
+}  // namespace vendor
+}  // namespace aidl
@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2024 The LineageOS Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#define LOG_TAG "ColorPipeline"
+
+#include <android-base/logging.h>
+#include <android-base/parseint.h>
+#include <android-base/strings.h>
+
+#include <hisi_paths.h>
+
+#include "ColorPipeline.h"
+
+using android::base::ParseInt;
+using android::base::Split;
+
+namespace aidl {
+namespace vendor {
+namespace lineage {
+namespace livedisplay {
+
+static constexpr const char* kColorPath = "/sys/devices/virtual/graphics/fb0/lcd_color_temperature";
+
+ColorPipeline::ColorPipeline() : mNode(hisi_path(kColorPath)) {
+    std::string tmp;
+
+    mSupported = mNode.IsValid();
+
+    // This HAL is the only writer of the node, so reading the panel
+    // state once is enough to know whether a write can be skipped.
+    if (mNode.Read(&tmp)) {
+        std::vector<std::string> values = Split(tmp, ",");
+        ColorMatrix matrix;
+        bool valid = values.size() == 9;
+        for (size_t i = 0; valid && i < 9; ++i) {
+            valid = ParseInt(values[i], &matrix.values[i]);
+        }
+        if (valid) mPanelMatrix = matrix;
+    } else {
+        LOG(ERROR) << "Failed to read color calibration file.";
+    }
+
+    // Whatever a previous instance left on the panel is replaced, even
+    // if nothing sets any of the parts.
+    {
+        std::lock_guard<std::mutex> lock(mStateMutex);
+        updateLocked();
+    }
+
+    mWriter = std::thread(&ColorPipeline::writerLoop, this);
+}
+
+ColorPipeline::~ColorPipeline() {
+    {
+        std::lock_guard<std::mutex> lock(mStateMutex);
+        mStopWriter = true;
+    }
+    mPendingMatrixCv.notify_one();
+    mWriter.join();
+}
+
+void ColorPipeline::setCalibration(const ColorMatrix& calibration) {
+    std::lock_guard<std::mutex> lock(mStateMutex);
+    mCalibration = calibration;
+    updateLocked();
+}
+
+void ColorPipeline::setMode(const ColorMatrix& mode) {
+    std::lock_guard<std::mutex> lock(mStateMutex);
+    mMode = mode;
+    updateLocked();
+}
+
+void ColorPipeline::setAdjustment(const ColorMatrix& adjustment) {
+    std::lock_guard<std::mutex> lock(mStateMutex);
+    mAdjustment = adjustment;
+    updateLocked();
+}
+
+void ColorPipeline::updateLocked() {
+    // The calibration (white point) is applied last, on top of the
+    // mode and the user's picture adjustment.
+    mPendingMatrix = (mCalibration * mMode * mAdjustment).normalized();
+    mHasPendingMatrix = true;
+    mPendingMatrixCv.notify_one();
+}
+
+void ColorPipeline::writerLoop() {
+    while (true) {
+        ColorMatrix matrix;
+        bool stopping;
+
+        {
+            std::unique_lock<std::mutex> lock(mStateMutex);
+            mPendingMatrixCv.wait(lock, [this] { return mHasPendingMatrix || mStopWriter; });
+
+            // The last update before destruction still makes it to the panel.
+            if (!mHasPendingMatrix) return;
+
+            matrix = mPendingMatrix;
+            mHasPendingMatrix = false;
+            stopping = mStopWriter;
+        }
+
+        // Nothing to do if the panel already shows this.
+        if (matrix == mPanelMatrix) continue;
+
+        if (mNode.Write(matrix.toString())) {
+            mPanelMatrix = matrix;
+        } else {
+            LOG(ERROR) << "Failed to write color calibration file.";
+        }
+
+        // Bound the write rate. Whatever comes in meanwhile replaces
+        // the pending matrix and gets written on the next iteration.
+        if (!stopping) std::this_thread::sleep_for(kMinWriteInterval);
+    }
+}
+
+}  // namespace livedisplay
+}  // namespace lineage
+}  // namespace vendor
+}  // namespace aidl
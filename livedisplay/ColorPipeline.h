@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2024 The LineageOS Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include <hisi_sysfs.h>
+
+#include "ColorMatrix.h"
+
+namespace aidl {
+namespace vendor {
+namespace lineage {
+namespace livedisplay {
+
+// Owns lcd_color_temperature. The calibration, display mode and picture
+// adjustment matrices are composed into the single matrix the panel
+// accepts, which is written asynchronously: rapid updates are coalesced,
+// writes are rate limited and values the panel already shows are skipped.
+// The node holds the composed matrix, so none of the parts can be read
+// back from it; each owner restores its own part at startup.
+class ColorPipeline {
+  public:
+    ColorPipeline();
+    ~ColorPipeline();
+
+    ColorPipeline(const ColorPipeline&) = delete;
+    ColorPipeline& operator=(const ColorPipeline&) = delete;
+
+    bool isSupported() const { return mSupported; }
+
+    void setCalibration(const ColorMatrix& calibration);
+    void setMode(const ColorMatrix& mode);
+    void setAdjustment(const ColorMatrix& adjustment);
+
+  private:
+    // Never write to the panel more often than this.
+    static constexpr std::chrono::milliseconds kMinWriteInterval{16};
+
+    void updateLocked();
+    void writerLoop();
+
+    // Read once at startup, then only used by the writer thread.
+    SysfsNode mNode;
+    bool mSupported = false;
+    ColorMatrix mPanelMatrix = ColorMatrix::identity();
+
+    std::mutex mStateMutex;
+    ColorMatrix mCalibration = ColorMatrix::identity();
+    ColorMatrix mMode = ColorMatrix::identity();
+    ColorMatrix mAdjustment = ColorMatrix::identity();
+
+    // Only the latest composed matrix is kept, older ones that were
+    // never written to the panel are simply dropped.
+    ColorMatrix mPendingMatrix;
+    bool mHasPendingMatrix = false;
+    bool mStopWriter = false;
+    std::condition_variable mPendingMatrixCv;
+    std::thread mWriter;
+};
+
+}  // namespace livedisplay
+}  // namespace lineage
+}  // namespace vendor
+}  // namespace aidl
@@ -6,80 +6,103 @@
 
 #define LOG_TAG "DisplayColorCalibration"
 
-#include <android-base/file.h>
 #include <android-base/logging.h>
+#include <android-base/parseint.h>
+#include <android-base/properties.h>
 #include <android-base/strings.h>
 
-#include <fstream>
-
 #include "DisplayColorCalibration.h"
 
-using android::base::ReadFileToString;
+using android::base::GetProperty;
+using android::base::ParseInt;
+using android::base::SetProperty;
 using android::base::Split;
-using android::base::Trim;
-using android::base::WriteStringToFile;
 
+namespace aidl {
 namespace vendor {
 namespace lineage {
 namespace livedisplay {
-namespace V2_0 {
-namespace hisi {
 
-static constexpr const char* kColorPath = "/sys/devices/virtual/graphics/fb0/lcd_color_temperature";
+static constexpr const char* kCalibrationProp = "persist.vendor.livedisplay.calibration";
 
-bool DisplayColorCalibration::isSupported() {
-    std::fstream rgb(kColorPath, rgb.in | rgb.out);
-    return rgb.good();
+static constexpr int32_t kMinValue = 1;
+static constexpr int32_t kMaxValue = 32768;
+
+DisplayColorCalibration::DisplayColorCalibration(std::shared_ptr<ColorPipeline> pipeline)
+    : mPipeline(std::move(pipeline)) {
+    std::array<int32_t, 3> colors = {kMaxValue, kMaxValue, kMaxValue};
+
+    // The panel only holds the composed matrix, so the calibration is
+    // kept on its own as "<r> <g> <b>".
+    std::vector<std::string> values = Split(GetProperty(kCalibrationProp, ""), " ");
+    if (values.size() == 3) {
+        std::array<int32_t, 3> stored;
+        bool valid = true;
+        for (size_t i = 0; valid && i < 3; ++i) {
+            valid = ParseInt(values[i], &stored[i], kMinValue, kMaxValue);
+        }
+        if (valid) colors = stored;
+    }
+
+    mCachedColors = packColors(colors);
+    mPipeline->setCalibration(ColorMatrix::diagonal(colors[0], colors[1], colors[2]));
 }
 
-Return<int32_t> DisplayColorCalibration::getMaxValue() {
-    return 32768;
+bool DisplayColorCalibration::isSupported() {
+    return mPipeline->isSupported();
 }
 
-Return<int32_t> DisplayColorCalibration::getMinValue() {
-    return 1;
+ndk::ScopedAStatus DisplayColorCalibration::getMaxValue(int32_t* _aidl_return) {
+    *_aidl_return = kMaxValue;
+    return ndk::ScopedAStatus::ok();
 }
 
-Return<void> DisplayColorCalibration::getCalibration(getCalibration_cb _hidl_cb) {
-    std::string tmp;
+ndk::ScopedAStatus DisplayColorCalibration::getMinValue(int32_t* _aidl_return) {
+    *_aidl_return = kMinValue;
+    return ndk::ScopedAStatus::ok();
+}
 
-    std::lock_guard<std::mutex> lock(mCachedColorsMutex);
-    if (ReadFileToString(kColorPath, &tmp)) {
-        std::vector<std::string> values = Split(Trim(tmp), ",");
-        if (values.size() == 9) {
-            mCachedColors[0] = std::stoi(values[0]);  // R
-            mCachedColors[1] = std::stoi(values[4]);  // G
-            mCachedColors[2] = std::stoi(values[8]);  // B
-        }
-    } else {
-        LOG(ERROR) << "Failed to read color calibration file.";
-    }
+uint64_t DisplayColorCalibration::packColors(const std::array<int32_t, 3>& colors) {
+    return static_cast<uint64_t>(colors[0] & 0xffff) << 32 |
+           static_cast<uint64_t>(colors[1] & 0xffff) << 16 | static_cast<uint64_t>(colors[2] & 0xffff);
+}
 
-    _hidl_cb(mCachedColors);
-    return Void();
+std::array<int32_t, 3> DisplayColorCalibration::unpackColors(uint64_t packed) {
+    return {static_cast<int32_t>(packed >> 32 & 0xffff), static_cast<int32_t>(packed >> 16 & 0xffff),
+            static_cast<int32_t>(packed & 0xffff)};
 }
 
-Return<bool> DisplayColorCalibration::setCalibration(const hidl_vec<int32_t>& rgb) {
-    std::string contents;
+ndk::ScopedAStatus DisplayColorCalibration::getCalibration(std::vector<int32_t>* _aidl_return) {
+    std::array<int32_t, 3> colors = unpackColors(mCachedColors.load(std::memory_order_acquire));
 
-    std::lock_guard<std::mutex> lock(mCachedColorsMutex);
-    for (size_t i = 0; i < rgb.size(); ++i) {
-        contents += std::to_string(rgb[i]);
+    *_aidl_return = {colors[0], colors[1], colors[2]};
+    return ndk::ScopedAStatus::ok();
+}
+
+ndk::ScopedAStatus DisplayColorCalibration::setCalibration(const std::vector<int32_t>& rgb) {
+    if (rgb.size() != 3) {
+        LOG(ERROR) << "Invalid color calibration, expected 3 values but got " << rgb.size();
+        return ndk::ScopedAStatus::fromExceptionCode(EX_ILLEGAL_ARGUMENT);
+    }
 
-        if (i < rgb.size() - 1) {
-            contents += ",0,0,0,";
+    for (int32_t value : rgb) {
+        if (value < kMinValue || value > kMaxValue) {
+            LOG(ERROR) << "Invalid color calibration, values out of range";
+            return ndk::ScopedAStatus::fromExceptionCode(EX_ILLEGAL_ARGUMENT);
         }
     }
 
-    mCachedColors[0] = rgb[0];  // R
-    mCachedColors[1] = rgb[1];  // G
-    mCachedColors[2] = rgb[2];  // B
+    mCachedColors.store(packColors({rgb[0], rgb[1], rgb[2]}), std::memory_order_release);
+    SetProperty(kCalibrationProp, android::base::Join(rgb, " "));
+
+    // The pipeline writes the panel asynchronously, so the caller
+    // doesn't have to wait for it.
+    mPipeline->setCalibration(ColorMatrix::diagonal(rgb[0], rgb[1], rgb[2]));
 
-    return WriteStringToFile(Trim(contents), kColorPath, true);
+    return ndk::ScopedAStatus::ok();
 }
 
-}  // namespace hisi
-}  // namespace V2_0
 }  // namespace livedisplay
 }  // namespace lineage
 }  // namespace vendor
+}  // namespace aidl
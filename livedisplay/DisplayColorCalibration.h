@@ -6,34 +6,41 @@
 
 #pragma once
 
-#include <vendor/lineage/livedisplay/2.0/IDisplayColorCalibration.h>
+#include <aidl/vendor/lineage/livedisplay/BnDisplayColorCalibration.h>
 
+#include <array>
+#include <atomic>
+#include <memory>
+
+#include "ColorPipeline.h"
+
+namespace aidl {
 namespace vendor {
 namespace lineage {
 namespace livedisplay {
-namespace V2_0 {
-namespace hisi {
-
-using ::android::hardware::hidl_vec;
-using ::android::hardware::Return;
-using ::android::hardware::Void;
 
-class DisplayColorCalibration : public IDisplayColorCalibration {
+class DisplayColorCalibration : public BnDisplayColorCalibration {
   public:
+    explicit DisplayColorCalibration(std::shared_ptr<ColorPipeline> pipeline);
+
     bool isSupported();
 
-    Return<int32_t> getMaxValue() override;
-    Return<int32_t> getMinValue() override;
-    Return<void> getCalibration(getCalibration_cb _hidl_cb) override;
-    Return<bool> setCalibration(const hidl_vec<int32_t>& rgb) override;
+    ndk::ScopedAStatus getMaxValue(int32_t* _aidl_return) override;
+    ndk::ScopedAStatus getMinValue(int32_t* _aidl_return) override;
+    ndk::ScopedAStatus getCalibration(std::vector<int32_t>* _aidl_return) override;
+    ndk::ScopedAStatus setCalibration(const std::vector<int32_t>& rgb) override;
 
   private:
-    std::vector<int32_t> mCachedColors = {32768, 32768, 32768};
-    std::mutex mCachedColorsMutex;
+    // The three 16 bit channels are packed into one word, so that
+    // readers can get a consistent snapshot without taking a lock.
+    static uint64_t packColors(const std::array<int32_t, 3>& colors);
+    static std::array<int32_t, 3> unpackColors(uint64_t packed);
+
+    std::shared_ptr<ColorPipeline> mPipeline;
+    std::atomic<uint64_t> mCachedColors;
 };
 
-}  // namespace hisi
-}  // namespace V2_0
 }  // namespace livedisplay
 }  // namespace lineage
 }  // namespace vendor
+}  // namespace aidl
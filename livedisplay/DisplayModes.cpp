@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2024 The LineageOS Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#define LOG_TAG "DisplayModes"
+
+#include <android-base/logging.h>
+#include <android-base/properties.h>
+
+#include "DisplayModes.h"
+
+using android::base::GetIntProperty;
+using android::base::SetProperty;
+
+namespace aidl {
+namespace vendor {
+namespace lineage {
+namespace livedisplay {
+
+static constexpr const char* kDefaultModeProp = "persist.vendor.livedisplay.display_mode";
+
+struct mode_def_t {
+    int32_t id;
+    const char* name;
+    float saturation;
+};
+
+// Saturation can only go down, boosting it needs coefficients above 1.0,
+// which the panel can't take. A stored default that no longer exists
+// falls back to the first mode.
+// clang-format off
+static constexpr mode_def_t kModeDefs[] = {
+    {0, "Standard", 1.0f},
+    {2, "Natural", 0.9f},
+};
+// clang-format on
+
+DisplayModes::DisplayModes(std::shared_ptr<ColorPipeline> pipeline)
+    : mPipeline(std::move(pipeline)) {
+    for (const auto& def : kModeDefs) {
+        DisplayMode mode;
+        mode.id = def.id;
+        mode.name = def.name;
+        mModes.push_back({mode, ColorMatrix::saturation(def.saturation)});
+        mModeList.push_back(mode);
+    }
+
+    // Restore the default mode, the panel always boots in the standard one.
+    const ModeInfo* info = findMode(defaultModeId());
+    mCurrentModeId = info->mode.id;
+    mPipeline->setMode(info->matrix);
+}
+
+bool DisplayModes::isSupported() {
+    return mPipeline->isSupported();
+}
+
+const DisplayModes::ModeInfo* DisplayModes::findMode(int32_t modeID) const {
+    for (const auto& info : mModes) {
+        if (info.mode.id == modeID) return &info;
+    }
+
+    return nullptr;
+}
+
+int32_t DisplayModes::defaultModeId() const {
+    int32_t id = GetIntProperty(kDefaultModeProp, kModeDefs[0].id);
+    return findMode(id) != nullptr ? id : kModeDefs[0].id;
+}
+
+ndk::ScopedAStatus DisplayModes::getDisplayModes(std::vector<DisplayMode>* _aidl_return) {
+    *_aidl_return = mModeList;
+    return ndk::ScopedAStatus::ok();
+}
+
+ndk::ScopedAStatus DisplayModes::getCurrentDisplayMode(DisplayMode* _aidl_return) {
+    *_aidl_return = findMode(mCurrentModeId.load(std::memory_order_relaxed))->mode;
+    return ndk::ScopedAStatus::ok();
+}
+
+ndk::ScopedAStatus DisplayModes::getDefaultDisplayMode(DisplayMode* _aidl_return) {
+    *_aidl_return = findMode(defaultModeId())->mode;
+    return ndk::ScopedAStatus::ok();
+}
+
+ndk::ScopedAStatus DisplayModes::setDisplayMode(int32_t modeID, bool makeDefault) {
+    const ModeInfo* info = findMode(modeID);
+    if (info == nullptr) {
+        LOG(ERROR) << "Invalid display mode: " << modeID;
+        return ndk::ScopedAStatus::fromExceptionCode(EX_ILLEGAL_ARGUMENT);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mSetModeMutex);
+        mCurrentModeId.store(modeID, std::memory_order_relaxed);
+        mPipeline->setMode(info->matrix);
+    }
+
+    if (makeDefault && !SetProperty(kDefaultModeProp, std::to_string(modeID))) {
+        LOG(ERROR) << "Failed to store the default display mode";
+        return ndk::ScopedAStatus::fromExceptionCode(EX_ILLEGAL_STATE);
+    }
+
+    return ndk::ScopedAStatus::ok();
+}
+
+}  // namespace livedisplay
+}  // namespace lineage
+}  // namespace vendor
+}  // namespace aidl
@@ -0,0 +1,57 @@
+/*
+ * Copyright (C) 2024 The LineageOS Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <aidl/vendor/lineage/livedisplay/BnDisplayModes.h>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "ColorPipeline.h"
+
+namespace aidl {
+namespace vendor {
+namespace lineage {
+namespace livedisplay {
+
+class DisplayModes : public BnDisplayModes {
+  public:
+    explicit DisplayModes(std::shared_ptr<ColorPipeline> pipeline);
+
+    bool isSupported();
+
+    ndk::ScopedAStatus getDisplayModes(std::vector<DisplayMode>* _aidl_return) override;
+    ndk::ScopedAStatus getCurrentDisplayMode(DisplayMode* _aidl_return) override;
+    ndk::ScopedAStatus getDefaultDisplayMode(DisplayMode* _aidl_return) override;
+    ndk::ScopedAStatus setDisplayMode(int32_t modeID, bool makeDefault) override;
+
+  private:
+    // Every mode's matrix is computed once at startup, switching modes
+    // is then a single multiply and one write to the panel.
+    struct ModeInfo {
+        DisplayMode mode;
+        ColorMatrix matrix;
+    };
+
+    const ModeInfo* findMode(int32_t modeID) const;
+    int32_t defaultModeId() const;
+
+    std::shared_ptr<ColorPipeline> mPipeline;
+    std::vector<ModeInfo> mModes;
+    std::vector<DisplayMode> mModeList;
+    std::atomic<int32_t> mCurrentModeId;
+
+    // Keeps the current mode in step with what was sent to the pipeline.
+    std::mutex mSetModeMutex;
+};
+
+}  // namespace livedisplay
+}  // namespace lineage
+}  // namespace vendor
+}  // namespace aidl
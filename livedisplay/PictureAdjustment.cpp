@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2024 The LineageOS Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#define LOG_TAG "PictureAdjustment"
+
+#include <android-base/logging.h>
+
+#include "PictureAdjustment.h"
+
+namespace aidl {
+namespace vendor {
+namespace lineage {
+namespace livedisplay {
+
+// Hue is in degrees, the others are percentages around the neutral 0.
+// Intensity and contrast are plain gains, and the panel can't go above
+// 1.0, so they can only be turned down.
+static constexpr int32_t kHueMin = -180;
+static constexpr int32_t kHueMax = 180;
+static constexpr float kSaturationMax = 100.0f;
+static constexpr float kIntensityMin = -50.0f;
+static constexpr float kContrastMin = -50.0f;
+
+static FloatRange MakeRange(float min, float max) {
+    FloatRange range;
+    range.min = min;
+    range.max = max;
+    range.step = max > min ? 1.0f : 0.0f;
+    return range;
+}
+
+static bool InRange(float value, const FloatRange& range) {
+    return value >= range.min && value <= range.max;
+}
+
+PictureAdjustment::PictureAdjustment(std::shared_ptr<ColorPipeline> pipeline)
+    : mPipeline(std::move(pipeline)) {}
+
+bool PictureAdjustment::isSupported() {
+    return mPipeline->isSupported();
+}
+
+ColorMatrix PictureAdjustment::toMatrix(const HSIC& hsic) {
+    // The panel only takes a 3x3 matrix without an offset, so contrast
+    // can't pivot around mid gray and ends up as a second gain stage.
+    return ColorMatrix::gain((1 + hsic.intensity / 100) * (1 + hsic.contrast / 100)) *
+           ColorMatrix::hue(hsic.hue) * ColorMatrix::saturation(1 + hsic.saturation / 100);
+}
+
+ndk::ScopedAStatus PictureAdjustment::getHueRange(Range* _aidl_return) {
+    _aidl_return->min = kHueMin;
+    _aidl_return->max = kHueMax;
+    return ndk::ScopedAStatus::ok();
+}
+
+ndk::ScopedAStatus PictureAdjustment::getSaturationRange(FloatRange* _aidl_return) {
+    *_aidl_return = MakeRange(-kSaturationMax, kSaturationMax);
+    return ndk::ScopedAStatus::ok();
+}
+
+ndk::ScopedAStatus PictureAdjustment::getIntensityRange(FloatRange* _aidl_return) {
+    *_aidl_return = MakeRange(kIntensityMin, 0.0f);
+    return ndk::ScopedAStatus::ok();
+}
+
+ndk::ScopedAStatus PictureAdjustment::getContrastRange(FloatRange* _aidl_return) {
+    *_aidl_return = MakeRange(kContrastMin, 0.0f);
+    return ndk::ScopedAStatus::ok();
+}
+
+ndk::ScopedAStatus PictureAdjustment::getSaturationThresholdRange(FloatRange* _aidl_return) {
+    // Not supported by the panel.
+    *_aidl_return = MakeRange(0.0f, 0.0f);
+    return ndk::ScopedAStatus::ok();
+}
+
+ndk::ScopedAStatus PictureAdjustment::getPictureAdjustment(HSIC* _aidl_return) {
+    std::lock_guard<std::mutex> lock(mHsicMutex);
+
+    *_aidl_return = mHsic;
+    return ndk::ScopedAStatus::ok();
+}
+
+ndk::ScopedAStatus PictureAdjustment::getDefaultPictureAdjustment(HSIC* _aidl_return) {
+    // Everything at the neutral 0.
+    *_aidl_return = HSIC();
+    return ndk::ScopedAStatus::ok();
+}
+
+ndk::ScopedAStatus PictureAdjustment::setPictureAdjustment(const HSIC& hsic) {
+    if (hsic.hue < kHueMin || hsic.hue > kHueMax ||
+        !InRange(hsic.saturation, MakeRange(-kSaturationMax, kSaturationMax)) ||
+        !InRange(hsic.intensity, MakeRange(kIntensityMin, 0.0f)) ||
+        !InRange(hsic.contrast, MakeRange(kContrastMin, 0.0f))) {
+        LOG(ERROR) << "Invalid picture adjustment, values out of range";
+        return ndk::ScopedAStatus::fromExceptionCode(EX_ILLEGAL_ARGUMENT);
+    }
+
+    // The matrix is built once per request, the pipeline then only has
+    // to multiply it with the calibration and the current mode.
+    ColorMatrix matrix = toMatrix(hsic);
+
+    // Both steps happen under one lock, so concurrent requests can't leave
+    // the panel showing a different adjustment than the one reported.
+    std::lock_guard<std::mutex> lock(mHsicMutex);
+    mHsic = hsic;
+    mPipeline->setAdjustment(matrix);
+
+    return ndk::ScopedAStatus::ok();
+}
+
+}  // namespace livedisplay
+}  // namespace lineage
+}  // namespace vendor
+}  // namespace aidl
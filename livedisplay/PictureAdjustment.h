@@ -0,0 +1,48 @@
+/*
+ * Copyright (C) 2024 The LineageOS Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <aidl/vendor/lineage/livedisplay/BnPictureAdjustment.h>
+
+#include <memory>
+#include <mutex>
+
+#include "ColorPipeline.h"
+
+namespace aidl {
+namespace vendor {
+namespace lineage {
+namespace livedisplay {
+
+class PictureAdjustment : public BnPictureAdjustment {
+  public:
+    explicit PictureAdjustment(std::shared_ptr<ColorPipeline> pipeline);
+
+    bool isSupported();
+
+    ndk::ScopedAStatus getHueRange(Range* _aidl_return) override;
+    ndk::ScopedAStatus getSaturationRange(FloatRange* _aidl_return) override;
+    ndk::ScopedAStatus getIntensityRange(FloatRange* _aidl_return) override;
+    ndk::ScopedAStatus getContrastRange(FloatRange* _aidl_return) override;
+    ndk::ScopedAStatus getSaturationThresholdRange(FloatRange* _aidl_return) override;
+    ndk::ScopedAStatus getPictureAdjustment(HSIC* _aidl_return) override;
+    ndk::ScopedAStatus getDefaultPictureAdjustment(HSIC* _aidl_return) override;
+    ndk::ScopedAStatus setPictureAdjustment(const HSIC& hsic) override;
+
+  private:
+    static ColorMatrix toMatrix(const HSIC& hsic);
+
+    std::shared_ptr<ColorPipeline> mPipeline;
+
+    std::mutex mHsicMutex;
+    HSIC mHsic;
+};
+
+}  // namespace livedisplay
+}  // namespace lineage
+}  // namespace vendor
+}  // namespace aidl
@@ -0,0 +1,153 @@
+/*
+ * Copyright (C) 2024 The LineageOS Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+
+#include "ColorMatrix.h"
+
+using aidl::vendor::lineage::livedisplay::ColorMatrix;
+
+using FloatMatrix = std::array<double, 9>;
+
+// One Q15 step, plus one more for every rounding on the way.
+static constexpr double kStep = 1.0 / ColorMatrix::kOne;
+
+static FloatMatrix ToFloat(const ColorMatrix& matrix) {
+    FloatMatrix result;
+    for (size_t i = 0; i < 9; ++i) result[i] = static_cast<double>(matrix.values[i]) * kStep;
+    return result;
+}
+
+static FloatMatrix Multiply(const FloatMatrix& a, const FloatMatrix& b) {
+    FloatMatrix result = {};
+    for (size_t row = 0; row < 3; ++row) {
+        for (size_t col = 0; col < 3; ++col) {
+            for (size_t k = 0; k < 3; ++k) result[row * 3 + col] += a[row * 3 + k] * b[k * 3 + col];
+        }
+    }
+    return result;
+}
+
+static void ExpectNear(const FloatMatrix& expected, const ColorMatrix& actual, double steps) {
+    FloatMatrix value = ToFloat(actual);
+    for (size_t i = 0; i < 9; ++i) {
+        EXPECT_NEAR(expected[i], value[i], steps * kStep) << "coefficient " << i;
+    }
+}
+
+static void ExpectPreservesGray(const ColorMatrix& matrix) {
+    FloatMatrix value = ToFloat(matrix);
+    for (size_t row = 0; row < 3; ++row) {
+        EXPECT_NEAR(1.0, value[row * 3] + value[row * 3 + 1] + value[row * 3 + 2], 3 * kStep)
+                << "row " << row;
+    }
+}
+
+TEST(ColorMatrixTest, FromFloatRoundsToNearest) {
+    FloatMatrix expected = {1.0, -0.5, 0.25, 1e-5, 0.3333, -1.0, 0.0, 0.75, 0.1};
+    std::array<float, 9> input;
+    for (size_t i = 0; i < 9; ++i) input[i] = static_cast<float>(expected[i]);
+
+    ExpectNear(expected, ColorMatrix::fromFloat(input), 0.5 + 1e-3);
+}
+
+TEST(ColorMatrixTest, MultiplyMatchesFloat) {
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> coefficient(-1.0f, 1.0f);
+
+    for (int i = 0; i < 1000; ++i) {
+        std::array<float, 9> a, b;
+        for (auto& value : a) value = coefficient(rng);
+        for (auto& value : b) value = coefficient(rng);
+
+        ColorMatrix qa = ColorMatrix::fromFloat(a);
+        ColorMatrix qb = ColorMatrix::fromFloat(b);
+
+        // Compare against the exact product of the quantized inputs, so
+        // only the rounding of the product itself is measured.
+        ExpectNear(Multiply(ToFloat(qa), ToFloat(qb)), qa * qb, 0.5 + 1e-6);
+    }
+}
+
+TEST(ColorMatrixTest, IdentityIsNeutral) {
+    ColorMatrix matrix = ColorMatrix::fromFloat({0.9f, 0.1f, 0.0f, 0.2f, 0.7f, 0.1f, 0.0f, 0.3f, 0.7f});
+
+    EXPECT_EQ(matrix, ColorMatrix::identity() * matrix);
+    EXPECT_EQ(matrix, matrix * ColorMatrix::identity());
+    EXPECT_EQ(ColorMatrix::identity(), ColorMatrix::hue(0));
+    EXPECT_EQ(ColorMatrix::identity(), ColorMatrix::saturation(1.0f));
+    EXPECT_EQ(ColorMatrix::identity(), ColorMatrix::gain(1.0f));
+}
+
+TEST(ColorMatrixTest, GainMatchesFloat) {
+    for (float factor : {0.5f, 0.75f, 0.9f, 1.0f}) {
+        ExpectNear({factor, 0, 0, 0, factor, 0, 0, 0, factor}, ColorMatrix::gain(factor), 0.5);
+    }
+}
+
+TEST(ColorMatrixTest, SaturationMatchesFloat) {
+    constexpr double kR = 0.2126, kG = 0.7152, kB = 0.0722;
+
+    for (double s : {0.0, 0.5, 0.9, 1.2, 2.0}) {
+        double r = (1 - s) * kR, g = (1 - s) * kG, b = (1 - s) * kB;
+        ColorMatrix matrix = ColorMatrix::saturation(static_cast<float>(s));
+
+        ExpectNear({r + s, g, b, r, g + s, b, r, g, b + s}, matrix, 1);
+        ExpectPreservesGray(matrix);
+    }
+}
+
+TEST(ColorMatrixTest, HuePreservesGray) {
+    for (float degrees : {-180.0f, -90.0f, -30.0f, 45.0f, 120.0f, 180.0f}) {
+        ExpectPreservesGray(ColorMatrix::hue(degrees));
+    }
+
+    // A full turn ends up where it started.
+    ExpectNear(ToFloat(ColorMatrix::identity()), ColorMatrix::hue(180) * ColorMatrix::hue(180), 8);
+}
+
+TEST(ColorMatrixTest, CompositionMatchesFloat) {
+    ColorMatrix calibration = ColorMatrix::diagonal(32768, 30000, 28000);
+    ColorMatrix mode = ColorMatrix::saturation(0.9f);
+    ColorMatrix adjustment =
+            ColorMatrix::gain(0.8f) * ColorMatrix::hue(30) * ColorMatrix::saturation(0.7f);
+
+    FloatMatrix expected =
+            Multiply(Multiply(ToFloat(calibration), ToFloat(mode)), ToFloat(adjustment));
+
+    // Every multiplication may be off by half a step, which then gets
+    // scaled by the following ones.
+    ExpectNear(expected, calibration * mode * adjustment, 4);
+}
+
+TEST(ColorMatrixTest, NormalizedScalesIntoRange) {
+    ColorMatrix matrix = ColorMatrix::saturation(1.5f);
+    ColorMatrix normalized = matrix.normalized();
+
+    FloatMatrix value = ToFloat(matrix);
+    double largest = 0;
+    for (double coefficient : value) largest = std::max(largest, std::abs(coefficient));
+    ASSERT_GT(largest, 1.0);
+
+    for (auto& coefficient : value) coefficient /= largest;
+    ExpectNear(value, normalized, 1);
+
+    for (int32_t coefficient : normalized.values) {
+        EXPECT_LE(std::abs(coefficient), ColorMatrix::kOne);
+    }
+
+    // Matrices already in range are left alone.
+    ColorMatrix in_range = ColorMatrix::saturation(0.5f);
+    EXPECT_EQ(in_range, in_range.normalized());
+}
+
+TEST(ColorMatrixTest, ToStringClamps) {
+    ColorMatrix matrix = {{40000, -40000, 1, 0, 32768, -32768, 2, 3, 4}};
+    EXPECT_EQ("32768,-32768,1,0,32768,-32768,2,3,4", matrix.toString());
+}
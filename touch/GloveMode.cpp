@@ -8,35 +8,45 @@
 
 #include "GloveMode.h"
 
-#include <fstream>
+#include <hisi_paths.h>
 
+namespace aidl {
 namespace vendor {
 namespace lineage {
 namespace touch {
-namespace V1_0 {
-namespace implementation {
 
 static constexpr const char* kGloveModePath = "/sys/touchscreen/touch_glove";
 
-Return<bool> GloveMode::isEnabled() {
-    std::ifstream file(kGloveModePath);
-    bool enabled;
+GloveMode::GloveMode() : mNode(hisi_path(kGloveModePath)) {}
 
-    file >> enabled;
+bool GloveMode::isSupported() {
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mNode.IsValid();
+}
+
+ndk::ScopedAStatus GloveMode::getEnabled(bool* _aidl_return) {
+    std::lock_guard<std::mutex> lock(mMutex);
+    int64_t enabled;
+
+    if (!mNode.ReadInt(&enabled)) {
+        return ndk::ScopedAStatus::fromExceptionCode(EX_ILLEGAL_STATE);
+    }
 
-    return enabled;
+    *_aidl_return = enabled != 0;
+    return ndk::ScopedAStatus::ok();
 }
 
-Return<bool> GloveMode::setEnabled(bool enabled) {
-    std::ofstream file(kGloveModePath);
+ndk::ScopedAStatus GloveMode::setEnabled(bool enabled) {
+    std::lock_guard<std::mutex> lock(mMutex);
 
-    file << enabled << std::flush;
+    if (!mNode.WriteInt(enabled ? 1 : 0)) {
+        return ndk::ScopedAStatus::fromExceptionCode(EX_ILLEGAL_STATE);
+    }
 
-    return !file.fail();
+    return ndk::ScopedAStatus::ok();
 }
 
-}  // namespace implementation
-}  // namespace V1_0
 }  // namespace touch
 }  // namespace lineage
 }  // namespace vendor
+}  // namespace aidl
@@ -6,25 +6,32 @@
 
 #pragma once
 
-#include <vendor/lineage/touch/1.0/IGloveMode.h>
+#include <aidl/vendor/lineage/touch/BnGloveMode.h>
 
+#include <mutex>
+
+#include <hisi_sysfs.h>
+
+namespace aidl {
 namespace vendor {
 namespace lineage {
 namespace touch {
-namespace V1_0 {
-namespace implementation {
-
-using ::android::hardware::Return;
 
-class GloveMode : public IGloveMode {
+class GloveMode : public BnGloveMode {
   public:
-    // Methods from ::vendor::lineage::touch::V1_0::IGloveMode follow.
-    Return<bool> isEnabled() override;
-    Return<bool> setEnabled(bool enabled) override;
+    GloveMode();
+
+    bool isSupported();
+
+    ndk::ScopedAStatus getEnabled(bool* _aidl_return) override;
+    ndk::ScopedAStatus setEnabled(bool enabled) override;
+
+  private:
+    std::mutex mMutex;
+    SysfsNode mNode;
 };
 
-}  // namespace implementation
-}  // namespace V1_0
 }  // namespace touch
 }  // namespace lineage
 }  // namespace vendor
+}  // namespace aidl
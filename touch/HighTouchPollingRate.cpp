@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2024 The LineageOS Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#define LOG_TAG "HighTouchPollingRateService"
+
+#include "HighTouchPollingRate.h"
+
+#include <android-base/file.h>
+#include <android-base/logging.h>
+#include <android-base/strings.h>
+#include <hisi_paths.h>
+
+#include <algorithm>
+
+namespace aidl {
+namespace vendor {
+namespace lineage {
+namespace touch {
+
+static constexpr const char* kReportRatePath = "/sys/touchscreen/report_rate";
+static constexpr const char* kScanModePath = "/sys/touchscreen/scan_mode";
+
+// One profile per line as "<name> <report_rate> [<scan_mode>]", i.e.
+// "game 1 2". The "default" and "high" profiles must be present.
+static constexpr const char* kProfilesPath = "/vendor/etc/touch_profiles.conf";
+
+// Used when the device doesn't ship any profiles.
+static const std::vector<HighTouchPollingRate::TouchProfile> kDefaultProfiles = {
+        {"default", "0", ""},
+        {"high", "1", ""},
+};
+
+static bool ParseProfiles(const std::string& contents,
+                          std::vector<HighTouchPollingRate::TouchProfile>* profiles) {
+    std::vector<HighTouchPollingRate::TouchProfile> result;
+
+    for (const auto& line : android::base::Split(contents, "\n")) {
+        std::string trimmed = android::base::Trim(line);
+        if (trimmed.empty() || trimmed[0] == '#') continue;
+
+        std::vector<std::string> fields;
+        for (auto& field : android::base::Split(trimmed, " \t")) {
+            if (!field.empty()) fields.push_back(std::move(field));
+        }
+
+        if (fields.size() < 2 || fields.size() > 3) {
+            LOG(ERROR) << "Invalid touch profile: " << trimmed;
+            return false;
+        }
+        result.push_back({fields[0], fields[1], fields.size() == 3 ? fields[2] : ""});
+    }
+
+    auto has = [&result](const char* name) {
+        return std::any_of(result.begin(), result.end(),
+                           [name](const auto& profile) { return profile.name == name; });
+    };
+    if (!has("default") || !has("high")) return false;
+
+    *profiles = std::move(result);
+    return true;
+}
+
+HighTouchPollingRate::HighTouchPollingRate()
+    : mReportRateNode(hisi_path(kReportRatePath)), mScanModeNode(hisi_path(kScanModePath)) {
+    loadProfiles();
+
+    // The panel keeps its report rate across service restarts, so start
+    // from whatever it is running at instead of assuming the default.
+    std::string reportRate;
+    if (mReportRateNode.IsValid() && mReportRateNode.Read(&reportRate)) {
+        mEnabled = reportRate == findProfile("high")->reportRate;
+    }
+}
+
+void HighTouchPollingRate::loadProfiles() {
+    std::string contents;
+
+    mProfiles = kDefaultProfiles;
+
+    // Devices can ship their own profiles, which replace the default ones.
+    if (android::base::ReadFileToString(hisi_path(kProfilesPath), &contents) &&
+        !ParseProfiles(contents, &mProfiles)) {
+        LOG(ERROR) << "Ignoring invalid " << kProfilesPath;
+        mProfiles = kDefaultProfiles;
+    }
+}
+
+bool HighTouchPollingRate::isSupported() {
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    return mReportRateNode.IsValid();
+}
+
+const HighTouchPollingRate::TouchProfile* HighTouchPollingRate::findProfile(
+        const std::string& name) const {
+    for (const auto& profile : mProfiles) {
+        if (profile.name == name) return &profile;
+    }
+
+    return nullptr;
+}
+
+bool HighTouchPollingRate::applyLocked() {
+    // An app profile wins over the user's setting while it is active.
+    const TouchProfile* profile = findProfile(mAppProfile);
+    if (profile == nullptr) profile = findProfile(mEnabled ? "high" : "default");
+
+    // Nodes that already show the value are not written again.
+    if (!mReportRateNode.Write(profile->reportRate)) return false;
+    if (!profile->scanMode.empty() && !mScanModeNode.Write(profile->scanMode)) return false;
+
+    return true;
+}
+
+ndk::ScopedAStatus HighTouchPollingRate::getEnabled(bool* _aidl_return) {
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    *_aidl_return = mEnabled;
+    return ndk::ScopedAStatus::ok();
+}
+
+ndk::ScopedAStatus HighTouchPollingRate::setEnabled(bool enabled) {
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    mEnabled = enabled;
+    if (!applyLocked()) {
+        return ndk::ScopedAStatus::fromExceptionCode(EX_UNSUPPORTED_OPERATION);
+    }
+
+    return ndk::ScopedAStatus::ok();
+}
+
+void HighTouchPollingRate::setAppProfile(const std::string& name) {
+    if (!name.empty() && findProfile(name) == nullptr) {
+        LOG(WARNING) << "Unknown touch profile: " << name;
+    }
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    mAppProfile = name;
+    applyLocked();
+}
+
+}  // namespace touch
+}  // namespace lineage
+}  // namespace vendor
+}  // namespace aidl
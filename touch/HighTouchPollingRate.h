@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2024 The LineageOS Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <aidl/vendor/lineage/touch/BnHighTouchPollingRate.h>
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <hisi_sysfs.h>
+
+namespace aidl {
+namespace vendor {
+namespace lineage {
+namespace touch {
+
+// Switches the touch report rate and scan mode between profiles. The
+// "default" and "high" profiles back the user facing setting, apps can
+// get their own profile through setAppProfile().
+class HighTouchPollingRate : public BnHighTouchPollingRate {
+  public:
+    typedef struct {
+        std::string name;
+        std::string reportRate;
+        // Empty leaves the scan mode alone.
+        std::string scanMode;
+    } TouchProfile;
+
+    HighTouchPollingRate();
+
+    bool isSupported();
+
+    ndk::ScopedAStatus getEnabled(bool* _aidl_return) override;
+    ndk::ScopedAStatus setEnabled(bool enabled) override;
+
+    // Switches to the profile of the app in the foreground, an empty or
+    // unknown name goes back to the user's setting.
+    void setAppProfile(const std::string& name);
+
+  private:
+    void loadProfiles();
+    const TouchProfile* findProfile(const std::string& name) const;
+    bool applyLocked();
+
+    std::vector<TouchProfile> mProfiles;
+
+    std::mutex mMutex;
+    bool mEnabled = false;
+    std::string mAppProfile;
+    SysfsNode mReportRateNode;
+    SysfsNode mScanModeNode;
+};
+
+}  // namespace touch
+}  // namespace lineage
+}  // namespace vendor
+}  // namespace aidl
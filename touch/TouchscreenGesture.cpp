@@ -7,67 +7,197 @@
 #define LOG_TAG "TouchscreenGestureService"
 
 #include "TouchscreenGesture.h"
-#include <fstream>
-#include <type_traits>
+
+#include <android-base/file.h>
+#include <android-base/logging.h>
+#include <android-base/parseint.h>
+#include <android-base/strings.h>
+#include <hisi_paths.h>
+#include <algorithm>
 #include <vector>
 
+namespace aidl {
 namespace vendor {
 namespace lineage {
 namespace touch {
-namespace V1_0 {
-namespace implementation {
 
 const std::string kGesturePath = "/sys/touchscreen/easy_wakeup_gesture";
+const std::string kSupportedGesturesPath = "/sys/touchscreen/easy_wakeup_supported_gestures";
+
+// One gesture per line as "<keycode> <mask> <name>", i.e. "66 0x080 Letter C".
+const std::string kGestureTablePath = "/vendor/etc/touch_gestures.conf";
 
-const std::vector<TouchscreenGesture::GestureInfo> TouchscreenGesture::kGestures = {
+// Used when the device doesn't ship a gesture table.
+const std::vector<TouchscreenGesture::GestureInfo> kDefaultGestures = {
         {66, "Letter C", 0x080},
         {67, "Letter e", 0x100},
         {68, "Letter M", 0x200},
         {87, "Letter W", 0x400},
 };
 
-Return<void> TouchscreenGesture::getSupportedGestures(getSupportedGestures_cb resultCb) {
-    std::vector<Gesture> gestures;
+static bool ParseGestureTable(const std::string& contents,
+                              std::vector<TouchscreenGesture::GestureInfo>* gestures) {
+    std::vector<TouchscreenGesture::GestureInfo> result;
+
+    for (const auto& line : android::base::Split(contents, "\n")) {
+        std::string trimmed = android::base::Trim(line);
+        if (trimmed.empty() || trimmed[0] == '#') continue;
+
+        // The name is the rest of the line and may contain spaces.
+        size_t keycodeEnd = trimmed.find_first_of(" \t");
+        size_t maskStart = trimmed.find_first_not_of(" \t", keycodeEnd);
+        size_t maskEnd = trimmed.find_first_of(" \t", maskStart);
+        size_t nameStart = trimmed.find_first_not_of(" \t", maskEnd);
+
+        TouchscreenGesture::GestureInfo gesture;
+        if (nameStart == std::string::npos ||
+            !android::base::ParseInt(trimmed.substr(0, keycodeEnd), &gesture.keycode) ||
+            !android::base::ParseUint(trimmed.substr(maskStart, maskEnd - maskStart),
+                                      &gesture.mask) ||
+            gesture.mask == 0) {
+            LOG(ERROR) << "Invalid gesture: " << trimmed;
+            return false;
+        }
+        gesture.name = trimmed.substr(nameStart);
+
+        result.push_back(gesture);
+    }
+
+    if (result.empty()) return false;
 
-    for (int i = 0; i < kGestures.size(); i++) {
-        gestures.push_back({i, kGestures[i].name, kGestures[i].keycode});
+    *gestures = std::move(result);
+    return true;
+}
+
+TouchscreenGesture::TouchscreenGesture(std::chrono::milliseconds debounceInterval)
+    : mDebounceInterval(debounceInterval), mNode(hisi_path(kGesturePath)) {
+    loadGestures();
+
+    // The node reports the mask in hex (i.e. "0x0180"), but takes it
+    // back as a plain decimal number.
+    if (!mNode.ReadHex(&mMask)) {
+        LOG(ERROR) << "Unable to read the gesture mask, assuming none are enabled";
     }
 
-    resultCb(gestures);
+    mWriter = std::thread(&TouchscreenGesture::writerLoop, this);
+}
 
-    return Void();
+TouchscreenGesture::~TouchscreenGesture() {
+    {
+        std::lock_guard<std::mutex> lock(mMaskMutex);
+        mStopWriter = true;
+    }
+    mMaskCv.notify_one();
+    mWriter.join();
+
+    flush();
+}
+
+bool TouchscreenGesture::isSupported() {
+    std::lock_guard<std::mutex> lock(mNodeMutex);
+    return !mSupportedGestures.empty() && mNode.IsValid();
 }
 
-Return<bool> TouchscreenGesture::setGestureEnabled(const Gesture& gesture, bool enabled) {
-    GestureInfo gestureInfo;
-    uint16_t gestureMode;
-    std::string line;
-    std::stringstream ss;
-    std::fstream file(kGesturePath);
+void TouchscreenGesture::loadGestures() {
+    std::vector<GestureInfo> gestures = kDefaultGestures;
+    std::string contents;
+    uint64_t supported;
 
-    if (gesture.id >= kGestures.size()) {
-        return false;
+    // Devices can ship their own table, which replaces the default one.
+    if (android::base::ReadFileToString(hisi_path(kGestureTablePath), &contents) &&
+        !ParseGestureTable(contents, &gestures)) {
+        LOG(ERROR) << "Ignoring invalid " << kGestureTablePath;
+        gestures = kDefaultGestures;
     }
 
-    gestureInfo = kGestures[gesture.id];
+    // Only offer what the panel can actually do, if the driver says so.
+    SysfsNode supportedNode(hisi_path(kSupportedGesturesPath));
+    if (supportedNode.IsValid() && supportedNode.ReadHex(&supported)) {
+        gestures.erase(std::remove_if(gestures.begin(), gestures.end(),
+                                      [supported](const GestureInfo& gesture) {
+                                          return (gesture.mask & supported) != gesture.mask;
+                                      }),
+                       gestures.end());
+    }
 
-    file >> line;
-    ss << std::hex << line.substr(2);
-    ss >> gestureMode;
+    for (size_t i = 0; i < gestures.size(); i++) {
+        Gesture gesture;
+        gesture.id = static_cast<int32_t>(i);
+        gesture.name = gestures[i].name;
+        gesture.keycode = gestures[i].keycode;
+        mSupportedGestures.push_back(std::move(gesture));
+    }
 
-    if (enabled) {
-        gestureMode |= gestureInfo.mask;
-    } else {
-        gestureMode &= ~gestureInfo.mask;
+    mGestures = std::move(gestures);
+}
+
+ndk::ScopedAStatus TouchscreenGesture::getSupportedGestures(std::vector<Gesture>* _aidl_return) {
+    *_aidl_return = mSupportedGestures;
+
+    return ndk::ScopedAStatus::ok();
+}
+
+ndk::ScopedAStatus TouchscreenGesture::setGestureEnabled(const Gesture& gesture, bool enabled) {
+    if (gesture.id < 0 || static_cast<size_t>(gesture.id) >= mGestures.size()) {
+        return ndk::ScopedAStatus::fromExceptionCode(EX_ILLEGAL_ARGUMENT);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mMaskMutex);
+        if (enabled) {
+            mMask |= mGestures[gesture.id].mask;
+        } else {
+            mMask &= ~mGestures[gesture.id].mask;
+        }
+        mDirty = true;
+        mToggles++;
+    }
+    mMaskCv.notify_one();
+
+    return ndk::ScopedAStatus::ok();
+}
+
+bool TouchscreenGesture::flush() {
+    std::lock_guard<std::mutex> nodeLock(mNodeMutex);
+    uint64_t mask;
+
+    {
+        std::lock_guard<std::mutex> lock(mMaskMutex);
+        if (!mDirty) return true;
+
+        mask = mMask;
+        mDirty = false;
     }
 
-    file << gestureMode;
+    return mNode.WriteInt(mask);
+}
 
-    return !file.fail();
+void TouchscreenGesture::writerLoop() {
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mMaskMutex);
+            mMaskCv.wait(lock, [this] { return mDirty || mStopWriter; });
+
+            // Give the rest of a burst (i.e. Settings restoring every
+            // gesture) the chance to land in the same write. Every
+            // toggle restarts the window, up to the deadline.
+            auto deadline =
+                    std::chrono::steady_clock::now() + mDebounceInterval * kMaxDebounceIntervals;
+            uint64_t toggles;
+            do {
+                toggles = mToggles;
+                auto window = std::chrono::steady_clock::now() + mDebounceInterval;
+                mMaskCv.wait_until(lock, std::min(window, deadline),
+                                   [this] { return mStopWriter; });
+                if (mStopWriter) return;
+            } while (toggles != mToggles && std::chrono::steady_clock::now() < deadline);
+        }
+
+        if (!flush()) LOG(ERROR) << "Unable to write the gesture mask";
+    }
 }
 
-}  // namespace implementation
-}  // namespace V1_0
 }  // namespace touch
 }  // namespace lineage
 }  // namespace vendor
+}  // namespace aidl
@@ -6,35 +6,73 @@
 
 #pragma once
 
-#include <vendor/lineage/touch/1.0/ITouchscreenGesture.h>
+#include <aidl/vendor/lineage/touch/BnTouchscreenGesture.h>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
 #include <vector>
 
+#include <hisi_sysfs.h>
+
+namespace aidl {
 namespace vendor {
 namespace lineage {
 namespace touch {
-namespace V1_0 {
-namespace implementation {
-
-using ::android::hardware::Return;
-using ::android::hardware::Void;
 
-class TouchscreenGesture : public ITouchscreenGesture {
+class TouchscreenGesture : public BnTouchscreenGesture {
   public:
-    // Methods from ::vendor::lineage::touch::V1_0::ITouchscreenGesture follow.
-    Return<void> getSupportedGestures(getSupportedGestures_cb resultCb) override;
-    Return<bool> setGestureEnabled(const Gesture& gesture, bool enabled) override;
-
-  private:
     typedef struct {
         int32_t keycode;
-        const char* name;
-        uint16_t mask;
+        std::string name;
+        uint64_t mask;
     } GestureInfo;
-    static const std::vector<GestureInfo> kGestures;
+
+    // Tests pass their own debounce interval to stay independent of timing.
+    explicit TouchscreenGesture(std::chrono::milliseconds debounceInterval = kDebounceInterval);
+    ~TouchscreenGesture();
+
+    bool isSupported();
+
+    ndk::ScopedAStatus getSupportedGestures(std::vector<Gesture>* _aidl_return) override;
+    ndk::ScopedAStatus setGestureEnabled(const Gesture& gesture, bool enabled) override;
+
+    // Writes the pending gesture mask right away.
+    bool flush();
+
+  private:
+    // The mask is written once no toggle arrived for this long, but a
+    // steady stream of toggles can defer it by at most kMaxDebounceIntervals.
+    static constexpr std::chrono::milliseconds kDebounceInterval{50};
+    static constexpr int kMaxDebounceIntervals = 4;
+
+    void loadGestures();
+    void writerLoop();
+
+    const std::chrono::milliseconds mDebounceInterval;
+
+    // The mask is only read from the node once, after that every update
+    // is applied to the shadow copy and written back asynchronously.
+    std::mutex mMaskMutex;
+    uint64_t mMask = 0;
+    bool mDirty = false;
+    // Bumped on every toggle, so the writer can tell the burst is still going.
+    uint64_t mToggles = 0;
+    bool mStopWriter = false;
+    std::condition_variable mMaskCv;
+
+    // Held across taking and writing a mask, so writes never go out of order.
+    std::mutex mNodeMutex;
+    SysfsNode mNode;
+    std::thread mWriter;
+
+    // Built once at startup, the gesture id is the index into both.
+    std::vector<GestureInfo> mGestures;
+    std::vector<Gesture> mSupportedGestures;
 };
 
-}  // namespace implementation
-}  // namespace V1_0
 }  // namespace touch
 }  // namespace lineage
 }  // namespace vendor
+}  // namespace aidl